@@ -0,0 +1,198 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(AVL_TREE_NODE_INDEX_LINKS) && (AVL_TREE_NODE_INDEX_BITS == 16)
+#define BENCH_POOL_NODES 65535U
+#elif defined(AVL_TREE_NODE_INDEX_LINKS)
+#define BENCH_POOL_NODES (1U << 24U)
+#endif
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+// avl_tree.h checks that the links address the whole pool.
+#define AVL_TREE_NODE_POOL_SIZE BENCH_POOL_NODES
+#endif
+
+#include "avl_tree.h"
+
+/*
+ * Measures insert, lookup, batch lookup, sorted batch lookup, Eytzinger and fat-leaf snapshot
+ * lookup and remove with random keys for the node layout selected with compile definitions, see
+ * CMakeLists.txt for the built variants.
+ *
+ * Usage: bench_avl_tree.elf [nodes]
+ *
+ * With AVL_TREE_NODE_INDEX_LINKS the nodes live in the static bench_node_pool, nodes is limited to
+ * its size.
+ */
+
+#if defined(AVL_TREE_NODE_INDEX_LINKS) && (AVL_TREE_NODE_INDEX_BITS == 16)
+#define BENCH_DEFAULT_NODES 65535U
+#else
+#define BENCH_DEFAULT_NODES 1000000U
+#endif
+#define BENCH_NSEC_PER_SEC 1000000000.0
+#define BENCH_BATCH_KEYS 32U
+#define BENCH_SORTED_KEYS 10000U
+
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+avl_node_t bench_node_pool[BENCH_POOL_NODES]; // AVL_TREE_NODE_POOL, index links address it
+#endif
+
+static uint64_t bench_random_state = 0x9E3779B97F4A7C15ULL;
+
+// xorshift64*, deterministic so that all variants see the same keys
+static inline uint64_t bench_random(void) {
+    bench_random_state ^= bench_random_state >> 12U;
+    bench_random_state ^= bench_random_state << 25U;
+    bench_random_state ^= bench_random_state >> 27U;
+    return bench_random_state * 0x2545F4914F6CDD1DULL;
+}
+
+static inline double bench_now(void) {
+    struct timespec now;
+    (void)timespec_get(&now, TIME_UTC);
+    return (double)now.tv_sec + ((double)now.tv_nsec / BENCH_NSEC_PER_SEC);
+}
+
+static inline void bench_report(const char *name, double start, size_t ops) {
+    double elapsed = bench_now() - start;
+    printf("%-10s %8.1f ns/op\n", name, (elapsed * BENCH_NSEC_PER_SEC) / (double)ops);
+}
+
+static int bench_key_cmp(const void *a, const void *b) {
+    avl_key_t key_a = *(const avl_key_t *)a;
+    avl_key_t key_b = *(const avl_key_t *)b;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+// Shuffle the visiting order so that lookups and removals do not follow insertion order.
+static inline void bench_shuffle(avl_node_t **order, size_t count) {
+    for (size_t i = count - 1; i > 0; i--) {
+        size_t j = (size_t)(bench_random() % (i + 1));
+        avl_node_t *tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    size_t count = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_NODES;
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+    avl_node_t *nodes = (count <= BENCH_POOL_NODES) ? bench_node_pool : NULL;
+#else
+    avl_node_t *nodes = calloc(count, sizeof(avl_node_t));
+#endif
+    avl_node_t **order = calloc(count, sizeof(avl_node_t *));
+    avl_key_t *sorted_keys = calloc(count, sizeof(avl_key_t));
+    avl_node_t **sorted_found = calloc(count, sizeof(avl_node_t *));
+    avl_key_t *snapshot_keys = calloc(count + 1, sizeof(avl_key_t));
+    avl_tree_eytzinger_t snapshot = {.keys = snapshot_keys, .nodes = NULL, .count = 0};
+    size_t fat_leaf_capacity = avl_tree_fat_leaf_capacity((avl_size_t)count);
+    avl_key_t *fat_leaf_keys = calloc(fat_leaf_capacity, sizeof(avl_key_t));
+    avl_tree_fat_leaf_t fat_leaf = {.keys = fat_leaf_keys, .nodes = NULL, .count = 0, .levels = 0};
+    avl_tree_t tree = {.root = NULL};
+    avl_key_t checksum = 0;
+    double start = 0;
+
+    if ((NULL == nodes) || (NULL == order) || (NULL == sorted_keys) || (NULL == sorted_found) ||
+        (NULL == snapshot_keys) || (NULL == fat_leaf_keys) || (0 == count)) {
+        fprintf(stderr, "cannot allocate %zu nodes\n", count);
+        return EXIT_FAILURE;
+    }
+    printf("nodes: %zu, avl_node_t: %zu bytes\n", count, sizeof(avl_node_t));
+
+    for (size_t i = 0; i < count; i++) {
+        nodes[i].key = (avl_key_t)bench_random();
+        order[i] = &nodes[i];
+    }
+
+    start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        (void)avl_tree_insert(&tree, &nodes[i]);
+    }
+    bench_report("insert", start, count);
+
+    bench_shuffle(order, count);
+    start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        checksum += avl_tree_node_lookup(tree.root, order[i]->key)->key;
+    }
+    bench_report("lookup", start, count);
+
+    start = bench_now();
+    (void)avl_tree_eytzinger_export(&snapshot, tree.root, (avl_size_t)count);
+    bench_report("export", start, count);
+    bench_shuffle(order, count);
+    start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        checksum += snapshot.keys[avl_tree_eytzinger_search(&snapshot, order[i]->key)];
+    }
+    bench_report("eytzinger", start, count);
+
+    (void)avl_tree_fat_leaf_export(&fat_leaf, tree.root, fat_leaf_capacity);
+    bench_shuffle(order, count);
+    start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        checksum += fat_leaf.keys[avl_tree_fat_leaf_search(&fat_leaf, order[i]->key)];
+    }
+    bench_report("fat_leaf", start, count);
+
+    bench_shuffle(order, count);
+    start = bench_now();
+    for (size_t i = 0; i < count; i += BENCH_BATCH_KEYS) {
+        avl_key_t keys[BENCH_BATCH_KEYS];
+        avl_node_t *found[BENCH_BATCH_KEYS];
+        size_t batch = ((count - i) < BENCH_BATCH_KEYS) ? (count - i) : BENCH_BATCH_KEYS;
+        for (size_t j = 0; j < batch; j++) {
+            keys[j] = order[i + j]->key;
+        }
+        avl_tree_node_lookup_batch(tree.root, keys, batch, found);
+        for (size_t j = 0; j < batch; j++) {
+            checksum += found[j]->key;
+        }
+    }
+    bench_report("batch", start, count);
+
+    // Random keys, sorted within each batch before the measurement.
+    bench_shuffle(order, count);
+    for (size_t i = 0; i < count; i++) {
+        sorted_keys[i] = order[i]->key;
+    }
+    for (size_t i = 0; i < count; i += BENCH_SORTED_KEYS) {
+        size_t batch = ((count - i) < BENCH_SORTED_KEYS) ? (count - i) : BENCH_SORTED_KEYS;
+        qsort(&sorted_keys[i], batch, sizeof(avl_key_t), bench_key_cmp);
+    }
+    start = bench_now();
+    for (size_t i = 0; i < count; i += BENCH_SORTED_KEYS) {
+        size_t batch = ((count - i) < BENCH_SORTED_KEYS) ? (count - i) : BENCH_SORTED_KEYS;
+        avl_tree_node_lookup_sorted(tree.root, &sorted_keys[i], batch, &sorted_found[i]);
+    }
+    bench_report("sorted", start, count);
+    for (size_t i = 0; i < count; i++) {
+        checksum += sorted_found[i]->key;
+    }
+
+    bench_shuffle(order, count);
+    start = bench_now();
+    for (size_t i = 0; i < count; i++) {
+        avl_node_t *node = avl_tree_node_lookup(tree.root, order[i]->key);
+        // Random 64-bit keys may collide, the duplicate was never inserted.
+        if (node == order[i]) {
+            avl_tree_remove(&tree, node);
+        }
+    }
+    bench_report("remove", start, count);
+
+    printf("checksum: %lx, left: %u\n", (unsigned long)checksum, avl_tree_count(&tree));
+    free(fat_leaf_keys);
+    free(snapshot_keys);
+    free(sorted_found);
+    free(sorted_keys);
+    free(order);
+#ifndef AVL_TREE_NODE_INDEX_LINKS
+    free(nodes);
+#endif
+    return EXIT_SUCCESS;
+}
@@ -6,6 +6,7 @@
  * @copyright Anton Ivanov, MIT License 2025
  */
 
+#include <limits.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -22,25 +23,367 @@
 #define TEST_PRINTF(...)
 #endif
 
+#ifndef AVL_TREE_REBALANCE_LEVELS_HOOK
+/**
+ * @brief Hook receiving the number of levels visited by one rebalancing walk.
+ *
+ * Define it before including this header to collect statistics, e.g. to confirm amortized O(1)
+ * rebalancing. Does nothing by default.
+ */
+#define AVL_TREE_REBALANCE_LEVELS_HOOK(levels) ((void)(levels))
+#endif
+
+#ifndef AVL_TREE_PREFETCH
+#ifdef __GNUC__
+/** @brief Prefetch a node for reading, a hint that never faults, not even for NULL. */
+#define AVL_TREE_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+/** @brief Prefetch a node, no portable way without compiler support. */
+#define AVL_TREE_PREFETCH(addr) ((void)(addr))
+#endif
+#endif
+
+#ifdef __GNUC__
+/**
+ * @brief Inline into every caller, for the descents taking an @ref avl_node_search_cmp_t.
+ *
+ * A comparison passed as a constant, as by AVL_TREE_DEFINE(), becomes a direct call, also where
+ * the compiler would keep one shared copy for callers with different comparisons.
+ */
+#define AVL_TREE_FORCE_INLINE static inline __attribute__((always_inline))
+#else
+/** @brief Inlining is left to the compiler without compiler support. */
+#define AVL_TREE_FORCE_INLINE static inline
+#endif
+
+#ifndef AVL_TREE_LOOKUP_BATCH_GROUP
+/** @brief Number of descents advanced in lockstep by avl_tree_node_lookup_batch(). */
+#define AVL_TREE_LOOKUP_BATCH_GROUP 16U
+#endif
 
+// Block search of the fat-leaf snapshot, AVL_TREE_FAT_LEAF_SCALAR forces the portable loop.
+#if !defined(AVL_TREE_FAT_LEAF_SCALAR) && defined(__GNUC__) && defined(__AVX2__)
+#include <immintrin.h>
+#define AVL_TREE_FAT_LEAF_AVX2
+#elif !defined(AVL_TREE_FAT_LEAF_SCALAR) && defined(__GNUC__) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define AVL_TREE_FAT_LEAF_SSE42
+#endif
+
+
+#ifndef AVL_TREE_KEY_BITS
+#define AVL_TREE_KEY_BITS 64
+#endif
+#if AVL_TREE_KEY_BITS == 64
 /** @brief Key type for AVL Tree: 64 bit */
 typedef uint64_t avl_key_t;
+#elif AVL_TREE_KEY_BITS == 32
+/** @brief Key type for AVL Tree: 32 bit, for small nodes */
+typedef uint32_t avl_key_t;
+#else
+#error "AVL_TREE_KEY_BITS must be 32 or 64"
+#endif
 typedef uint8_t avl_height_t; ///< for max key ( 2^64 ) max height < 1.44 * log2(n) ~ 92
+typedef uint32_t avl_size_t;  ///< number of nodes in a subtree
+
+/** @brief Upper bound of AVL-Tree height, see @ref avl_height_t. */
+#define AVL_TREE_MAX_HEIGHT 92U
+
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+#ifndef AVL_TREE_NODE_POOL
+#error "AVL_TREE_NODE_INDEX_LINKS requires AVL_TREE_NODE_POOL to name the node array"
+#endif
+#ifdef AVL_TREE_NODE_KEY_OFFSET
+#error "AVL_TREE_NODE_KEY_OFFSET needs nodes embedded in containers, not in AVL_TREE_NODE_POOL"
+#endif
+#ifndef AVL_TREE_NODE_INDEX_BITS
+#define AVL_TREE_NODE_INDEX_BITS 32
+#endif
+#if AVL_TREE_NODE_INDEX_BITS == 32
+/** @brief Link to a node: index into AVL_TREE_NODE_POOL plus one, 0 is NULL. */
+typedef uint32_t avl_link_t;
+#elif AVL_TREE_NODE_INDEX_BITS == 16
+/** @brief Link to a node: index into AVL_TREE_NODE_POOL plus one, 0 is NULL (max 65535 nodes). */
+typedef uint16_t avl_link_t;
+#else
+#error "AVL_TREE_NODE_INDEX_BITS must be 16 or 32"
+#endif
+#else
+/** @brief Link to a node. */
+typedef struct avl_node_s *avl_link_t;
+#endif
+
+/** @brief Direction of a child: AVL_DIR_LEFT or AVL_DIR_RIGHT, see avl_node_child(). */
+typedef uint32_t avl_dir_t;
+#define AVL_DIR_LEFT 0U
+#define AVL_DIR_RIGHT 1U
 
-/** @brief AVL Tree node. */
+#if defined(AVL_TREE_NODE_BALANCE_FACTOR) && !defined(AVL_TREE_NODE_INDEX_LINKS) && \
+    !defined(AVL_TREE_NODE_NO_PARENT)
+/** @brief Balance factor is packed into the parent pointer, nodes are at least 4 byte aligned. */
+#define AVL_TREE_NODE_BALANCE_IN_PARENT
+#define AVL_TREE_NODE_BALANCE_MASK ((uintptr_t)3U)
+#endif
+
+/**
+ * @brief AVL Tree node.
+ *
+ * Links are only accessed through avl_node_left() and friends, see AVL_TREE_NODE_INDEX_LINKS.
+ * With AVL_TREE_NODE_BALANCE_FACTOR the height is replaced by the balance factor.
+ * With AVL_TREE_NODE_NO_PARENT there is no parent link, rebalancing uses @ref avl_node_path_t.
+ * With AVL_TREE_NODE_CHILD_ARRAY the children are an array indexed by @ref avl_dir_t.
+ * With AVL_TREE_NODE_KEY_OFFSET the key is not in the node, see avl_node_key().
+ */
 typedef struct avl_node_s {
+#ifndef AVL_TREE_NODE_KEY_OFFSET
     avl_key_t key;
-    struct avl_node_s *left;
-    struct avl_node_s *right;
-    struct avl_node_s *parent; ///< for easier balancing and to avoid recursion
+#endif
+#ifdef AVL_TREE_NODE_CHILD_ARRAY
+    avl_link_t child[2]; ///< left and right child, indexed by direction
+#else
+    avl_link_t left;
+    avl_link_t right;
+#endif
+#ifdef AVL_TREE_NODE_BALANCE_IN_PARENT
+    uintptr_t parent; ///< parent pointer, balance factor in the two low bits
+#elif !defined(AVL_TREE_NODE_NO_PARENT)
+    avl_link_t parent; ///< for easier balancing and to avoid recursion
+#endif
+#ifndef AVL_TREE_NODE_BALANCE_FACTOR
     avl_height_t height;
+#elif !defined(AVL_TREE_NODE_BALANCE_IN_PARENT)
+    int8_t balance; ///< height of right minus height of left subtree: -1, 0 or 1
+#endif
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_size_t size; ///< number of nodes in the subtree, for rank and select
+#endif
 } avl_node_t;
 
 /** @brief AVL Tree. */
 typedef struct avl_tree_s {
     avl_node_t *root;
+    avl_size_t count; ///< number of nodes, maintained by the avl_tree_t functions
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    avl_node_t *min; ///< node with minimum key, NULL if the tree is empty
+    avl_node_t *max; ///< node with maximum key, NULL if the tree is empty
+#endif
 } avl_tree_t;
 
+/**
+ * @brief Nodes on the way from the root down to a node.
+ *
+ * AVL-Tree height is bounded, so the path fits into a fixed-size array on the stack and no
+ * recursion is needed to walk back up. The in-order walks keep their pending nodes in it, with
+ * AVL_TREE_NODE_NO_PARENT the rebalancing walks climb it instead of the parent links.
+ */
+typedef struct {
+    avl_node_t *nodes[AVL_TREE_MAX_HEIGHT]; ///< nodes[0] is the root
+    uint32_t depth;                         ///< number of nodes on the path
+} avl_node_path_t;
+
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+#ifdef AVL_TREE_NODE_POOL_SIZE
+/** @brief Statically allocated node pool of AVL_TREE_NODE_POOL_SIZE nodes, defined by the user. */
+extern avl_node_t AVL_TREE_NODE_POOL[AVL_TREE_NODE_POOL_SIZE];
+_Static_assert((AVL_TREE_NODE_POOL_SIZE) <= (avl_link_t)~0U,
+               "AVL_TREE_NODE_POOL has more nodes than AVL_TREE_NODE_INDEX_BITS links address");
+#else
+/** @brief Statically allocated node pool, defined by the user. */
+extern avl_node_t AVL_TREE_NODE_POOL[];
+#endif
+#endif
+
+/**
+ * @brief Pointer to the struct of type containing member, given a pointer to member.
+ *
+ * Nodes are embedded into the structs they order, AVL_CONTAINER_OF(node, item_t, node) returns
+ * the item of a node found by lookup or iteration.
+ */
+#define AVL_CONTAINER_OF(ptr, type, member)                                                        \
+    ((type *)(void *)((char *)(ptr) - offsetof(type, member)))
+
+/**
+ * @brief Byte offset from member node_member to member key_member of type.
+ *
+ * Meant to check AVL_TREE_NODE_KEY_OFFSET once the container is defined:
+ * _Static_assert(AVL_NODE_KEY_OFFSET(item_t, node, key) == AVL_TREE_NODE_KEY_OFFSET, "...");
+ */
+#define AVL_NODE_KEY_OFFSET(type, node_member, key_member)                                         \
+    ((ptrdiff_t)offsetof(type, key_member) - (ptrdiff_t)offsetof(type, node_member))
+
+/**
+ * @brief Key of node.
+ *
+ * With AVL_TREE_NODE_KEY_OFFSET the key lives in the struct containing the node, at that
+ * constant byte offset from the node, and nodes hold links only. The offset has to be an integer
+ * constant expression, since the container is not complete before this header is included.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Key @ref avl_key_t.
+ */
+static inline avl_key_t avl_node_key(const avl_node_t *node) {
+#ifdef AVL_TREE_NODE_KEY_OFFSET
+    return *(const avl_key_t *)(const void *)((const char *)node + (AVL_TREE_NODE_KEY_OFFSET));
+#else
+    return node->key;
+#endif
+}
+
+/**
+ * @brief Resolve link to node.
+ *
+ * @param link Link @ref avl_link_t.
+ * @return Node @ref avl_node_t or NULL.
+ */
+static inline avl_node_t *avl_link_to_node(avl_link_t link) {
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+    return (0U == link) ? NULL : &AVL_TREE_NODE_POOL[link - 1U];
+#else
+    return link;
+#endif
+}
+
+/**
+ * @brief Convert node to link.
+ *
+ * With index links the index plus one has to fit into @ref avl_link_t, nodes beyond would be
+ * truncated to links of other nodes. Define AVL_TREE_NODE_POOL_SIZE to reject a too large pool at
+ * compile time.
+ *
+ * @param node Node @ref avl_node_t or NULL, must be part of AVL_TREE_NODE_POOL with index links.
+ * @return Link @ref avl_link_t.
+ */
+static inline avl_link_t avl_node_to_link(avl_node_t *node) {
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+    TEST_ASSERT((NULL == node) || ((node >= AVL_TREE_NODE_POOL) &&
+                                   ((node - AVL_TREE_NODE_POOL) < (ptrdiff_t)(avl_link_t)~0U)));
+    return (NULL == node) ? 0U : (avl_link_t)((node - AVL_TREE_NODE_POOL) + 1);
+#else
+    return node;
+#endif
+}
+
+/** @brief Child of node in direction dir, a plain array access with AVL_TREE_NODE_CHILD_ARRAY. */
+static inline avl_node_t *avl_node_child(const avl_node_t *node, avl_dir_t dir) {
+#ifdef AVL_TREE_NODE_CHILD_ARRAY
+    return avl_link_to_node(node->child[dir]);
+#else
+    return avl_link_to_node((AVL_DIR_RIGHT == dir) ? node->right : node->left);
+#endif
+}
+
+/** @brief Left child of node. */
+static inline avl_node_t *avl_node_left(const avl_node_t *node) {
+    return avl_node_child(node, AVL_DIR_LEFT);
+}
+
+/** @brief Right child of node. */
+static inline avl_node_t *avl_node_right(const avl_node_t *node) {
+    return avl_node_child(node, AVL_DIR_RIGHT);
+}
+
+#ifndef AVL_TREE_NODE_NO_PARENT
+/** @brief Parent of node. */
+static inline avl_node_t *avl_node_parent(const avl_node_t *node) {
+#ifdef AVL_TREE_NODE_BALANCE_IN_PARENT
+    // NOLINTNEXTLINE(performance-no-int-to-ptr) -- pointer with tag bits cleared
+    return (avl_node_t *)(node->parent & ~AVL_TREE_NODE_BALANCE_MASK);
+#else
+    return avl_link_to_node(node->parent);
+#endif
+}
+#endif
+
+/** @brief Set child of node in direction dir. */
+static inline void avl_node_set_child(avl_node_t *node, avl_dir_t dir, avl_node_t *child) {
+#ifdef AVL_TREE_NODE_CHILD_ARRAY
+    node->child[dir] = avl_node_to_link(child);
+#else
+    if (AVL_DIR_RIGHT == dir) {
+        node->right = avl_node_to_link(child);
+    } else {
+        node->left = avl_node_to_link(child);
+    }
+#endif
+}
+
+/** @brief Set left child of node. */
+static inline void avl_node_set_left(avl_node_t *node, avl_node_t *left) {
+    avl_node_set_child(node, AVL_DIR_LEFT, left);
+}
+
+/** @brief Set right child of node. */
+static inline void avl_node_set_right(avl_node_t *node, avl_node_t *right) {
+    avl_node_set_child(node, AVL_DIR_RIGHT, right);
+}
+
+/** @brief Set parent of node, does nothing with AVL_TREE_NODE_NO_PARENT. */
+static inline void avl_node_set_parent(avl_node_t *node, avl_node_t *parent) {
+#if defined(AVL_TREE_NODE_NO_PARENT)
+    (void)node;
+    (void)parent;
+#elif defined(AVL_TREE_NODE_BALANCE_IN_PARENT)
+    TEST_ASSERT(0U == ((uintptr_t)parent & AVL_TREE_NODE_BALANCE_MASK));
+    node->parent = (uintptr_t)parent | (node->parent & AVL_TREE_NODE_BALANCE_MASK);
+#else
+    node->parent = avl_node_to_link(parent);
+#endif
+}
+
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+/**
+ * @brief Return stored balance factor of node.
+ *
+ * Balance factor is difference between height of right and left subtrees.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Node's balance factor: -1, 0 or 1.
+ */
+static inline int32_t avl_node_balance_factor(const avl_node_t *node) {
+    TEST_ASSERT(NULL != node);
+#ifdef AVL_TREE_NODE_BALANCE_IN_PARENT
+    // Two bit two's complement: 0, 1 and 3 for -1.
+    return (int32_t)((node->parent & AVL_TREE_NODE_BALANCE_MASK) ^ 2U) - 2;
+#else
+    return node->balance;
+#endif
+}
+
+/**
+ * @brief Store balance factor of node.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @param balance_factor Balance factor: -1, 0 or 1.
+ */
+static inline void avl_node_set_balance_factor(avl_node_t *node, int32_t balance_factor) {
+    TEST_ASSERT((balance_factor >= -1) && (balance_factor <= 1));
+#ifdef AVL_TREE_NODE_BALANCE_IN_PARENT
+    node->parent = (node->parent & ~AVL_TREE_NODE_BALANCE_MASK) |
+                   ((uintptr_t)(uint32_t)balance_factor & AVL_TREE_NODE_BALANCE_MASK);
+#else
+    node->balance = (int8_t)balance_factor;
+#endif
+}
+#endif
+
+/** @brief Append node to the path. */
+static inline void avl_node_path_push(avl_node_path_t *path, avl_node_t *node) {
+    TEST_ASSERT(path->depth < AVL_TREE_MAX_HEIGHT);
+    path->nodes[path->depth++] = node;
+}
+
+/** @brief Last node of the path, NULL if the path is empty. */
+static inline avl_node_t *avl_node_path_top(const avl_node_path_t *path) {
+    return (0U == path->depth) ? NULL : path->nodes[path->depth - 1U];
+}
+
+/** @brief Push node and its chain of left children to the path of an in-order walk. */
+static inline void avl_node_path_push_left(avl_node_path_t *path, avl_node_t *node) {
+    for (avl_node_t *current = node; NULL != current; current = avl_node_left(current)) {
+        avl_node_path_push(path, current);
+    }
+}
+
 /** @brief A type holding node comparison results for this AVL Tree implementation */
 typedef enum {
     AVL_CMP_EQ,
@@ -48,49 +391,190 @@ typedef enum {
     AVL_CMP_GT,
 } avl_node_cmp_result_t;
 
+/** @brief Direction to descend for a comparison result other than AVL_CMP_EQ. */
+static inline avl_dir_t avl_cmp_dir(avl_node_cmp_result_t cmp_result) {
+    return (AVL_CMP_GT == cmp_result) ? AVL_DIR_RIGHT : AVL_DIR_LEFT;
+}
+
 #ifdef BUILD_UNIT_TESTS
 #define AVL_NODE_TO_STR_BUFF_SIZE 21
+// Nodes are named by address, with AVL_TREE_NODE_KEY_OFFSET or in generated trees the key is not
+// part of the node.
 static inline char *avl_node_to_str(avl_node_t *node) {
-    static char ret_str[AVL_NODE_TO_STR_BUFF_SIZE]; // Enough to hold a uint64_t + null terminator
+    static char ret_str[AVL_NODE_TO_STR_BUFF_SIZE]; // Enough to hold a pointer + null terminator
     if (NULL == node) {
         // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
         (void)snprintf(ret_str, strlen("NULL") + 1, "%s", "NULL");
     } else {
         // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.DeprecatedOrUnsafeBufferHandling)
-        (void)snprintf(ret_str, AVL_NODE_TO_STR_BUFF_SIZE, "%lu", node->key);
+        (void)snprintf(ret_str, AVL_NODE_TO_STR_BUFF_SIZE, "%p", (void *)node);
     }
     return ret_str;
 }
 #endif
 
 
-#ifndef AVL_TREE_NODE_CMP_FN_EXTERNAL
+#ifdef AVL_TREE_NODE_CMP_FN_EXTERNAL
+/** @brief Node comparison function provided by the user, see below. */
+avl_node_cmp_result_t avl_node_cmp(avl_node_t *node_a, avl_node_t *node_b);
+#endif
+
+#ifdef AVL_TREE_KEY_CMP_FN_EXTERNAL
+/** @brief Key comparison function provided by the user, see below. */
+avl_node_cmp_result_t avl_node_key_cmp(const avl_key_t *key, const avl_node_t *node);
+#elif defined(AVL_TREE_NODE_CMP_FN_EXTERNAL) && defined(AVL_TREE_NODE_KEY_OFFSET)
+#error "External avl_node_cmp() with AVL_TREE_NODE_KEY_OFFSET needs AVL_TREE_KEY_CMP_FN_EXTERNAL"
+#elif defined(AVL_TREE_NODE_CMP_FN_EXTERNAL)
 /**
- * @brief Node comparison function: left is smaller, right is larger.
+ * @brief Key comparison function deferring to the external avl_node_cmp().
  *
- *  64-bit key paired with 32-bit collision index for cases when keys match.
+ * Lookups order like inserts: the key is put into a probe node on the stack, so the external
+ * avl_node_cmp() must only read the key of its first node. Provide avl_node_key_cmp() as well
+ * with AVL_TREE_KEY_CMP_FN_EXTERNAL to avoid the probe.
  */
-static inline avl_node_cmp_result_t avl_node_cmp(avl_node_t *node_a, avl_node_t *node_b) {
+static inline avl_node_cmp_result_t avl_node_key_cmp(const avl_key_t *key,
+                                                     const avl_node_t *node) {
+    avl_node_t probe = {.key = *key};
+    return avl_node_cmp(&probe, (avl_node_t *)node);
+}
+#else
+/**
+ * @brief Key comparison function: compare a search key with the key of node.
+ *
+ * All lookups by key call it with a borrowed key, no node is built around the key. Provided by
+ * the user with AVL_TREE_KEY_CMP_FN_EXTERNAL, ordering like avl_node_cmp().
+ */
+static inline avl_node_cmp_result_t avl_node_key_cmp(const avl_key_t *key,
+                                                     const avl_node_t *node) {
     avl_node_cmp_result_t res = AVL_CMP_EQ;
-    if (node_a->key < node_b->key) {
+    avl_key_t node_key = avl_node_key(node);
+    if (*key < node_key) {
         res = AVL_CMP_LT;
-    } else if (node_a->key > node_b->key) {
+    } else if (*key > node_key) {
         res = AVL_CMP_GT;
     }
     return res;
 }
 #endif
 
+#ifndef AVL_TREE_NODE_CMP_FN_EXTERNAL
+/**
+ * @brief Node comparison function: left is smaller, right is larger.
+ *
+ * Compares the key of node_a, so an external avl_node_key_cmp() orders the nodes as well.
+ */
+static inline avl_node_cmp_result_t avl_node_cmp(avl_node_t *node_a, avl_node_t *node_b) {
+    avl_key_t key_a = avl_node_key(node_a);
+    return avl_node_key_cmp(&key_a, node_b);
+}
+#endif
+
+/**
+ * @brief Comparison of a search key of another type with the key of node.
+ *
+ * @param search_key Search key, type agreed between caller and function.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Order of search_key relative to node @ref avl_node_cmp_result_t.
+ */
+typedef avl_node_cmp_result_t (*avl_node_search_cmp_t)(const void *search_key,
+                                                       const avl_node_t *node);
+
+/**
+ * @brief avl_node_key_cmp() as @ref avl_node_search_cmp_t, the search key is an @ref avl_key_t.
+ *
+ * The functions by key pass it to their *_by() counterpart, which takes any comparison.
+ */
+static inline avl_node_cmp_result_t avl_node_search_key_cmp(const void *search_key,
+                                                            const avl_node_t *node) {
+    return avl_node_key_cmp((const avl_key_t *)search_key, node);
+}
+
+/**
+ * @brief avl_node_cmp() as @ref avl_node_search_cmp_t, the search key is a node.
+ *
+ * Functions locating or placing a given node order it with a comparison of this kind, the
+ * functions of avl_tree_define.h pass one ordering their own node type.
+ */
+static inline avl_node_cmp_result_t avl_node_search_node_cmp(const void *search_node,
+                                                             const avl_node_t *node) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) -- avl_node_cmp() reads only
+    return avl_node_cmp((avl_node_t *)search_node, (avl_node_t *)node);
+}
+
 /**
  * @brief Return node's height.
  *
+ * With AVL_TREE_NODE_BALANCE_FACTOR the height is not stored: it is the length of the path
+ * following the higher child, O(log n).
+ *
  * @param node AVL-Tree node @ref avl_node_t.
  * @return Height of node's subtree.
  */
 static inline avl_height_t avl_node_height(avl_node_t *node) {
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    avl_height_t height = 0;
+    avl_node_t *current = node;
+    while (NULL != current) {
+        height++;
+        current = (avl_node_balance_factor(current) < 0) ? avl_node_left(current)
+                                                          : avl_node_right(current);
+    }
+    return height;
+#else
     return (NULL == node) ? 0 : node->height;
+#endif
+}
+
+#ifdef AVL_TREE_ORDER_STATISTICS
+/**
+ * @brief Return number of nodes in node's subtree.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Size of node's subtree.
+ */
+static inline avl_size_t avl_node_size(avl_node_t *node) {
+    return (NULL == node) ? 0 : node->size;
+}
+
+/**
+ * @brief Recalculate size of node's subtree.
+ *
+ * This function relies on the size of the left and right subtrees being correct.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ */
+static inline void avl_node_size_calc(avl_node_t *node) {
+    node->size = avl_node_size(avl_node_left(node)) + avl_node_size(avl_node_right(node)) + 1;
 }
 
+#ifdef AVL_TREE_NODE_NO_PARENT
+/**
+ * @brief Recalculate subtree sizes of the nodes on a path, from the bottom up to the root.
+ *
+ * @param path Path @ref avl_node_path_t whose last node is the lowest one to update.
+ */
+static inline void avl_node_path_size_update(const avl_node_path_t *path) {
+    for (uint32_t depth = path->depth; depth > 0U; depth--) {
+        avl_node_size_calc(path->nodes[depth - 1U]);
+    }
+}
+#else
+/**
+ * @brief Recalculate subtree sizes from node up to the root.
+ *
+ * @param node AVL-Tree node @ref avl_node_t to start from, may be NULL.
+ */
+static inline void avl_node_size_path_update(avl_node_t *node) {
+    avl_node_t *current = node;
+    while (NULL != current) {
+        avl_node_size_calc(current);
+        current = avl_node_parent(current);
+    }
+}
+#endif
+#endif
+
+#ifndef AVL_TREE_NODE_BALANCE_FACTOR
 /**
  * @brief Calculate balance factor of node.
  *
@@ -99,11 +583,13 @@ static inline avl_height_t avl_node_height(avl_node_t *node) {
  * @param node AVL-Tree node @ref avl_node_t.
  * @return Node's balance factor.
  */
-static inline int32_t avl_node_balance_factor(avl_node_t *node) {
+static inline int32_t avl_node_balance_factor(const avl_node_t *node) {
     TEST_ASSERT(NULL != node);
     // NOLINTNEXTLINE(clang-analyzer-core.NullDereference) -- algorithmically not possible
-    return (int32_t)avl_node_height(node->right) - (int32_t)avl_node_height(node->left);
+    return (int32_t)avl_node_height(avl_node_right(node)) -
+           (int32_t)avl_node_height(avl_node_left(node));
 }
+#endif
 
 /**
  * @brief Find node with minimum key in AVL-subtree.
@@ -114,305 +600,2583 @@ static inline int32_t avl_node_balance_factor(avl_node_t *node) {
 static inline avl_node_t *avl_node_find_min(avl_node_t *node) {
     avl_node_t *current = node;
     TEST_ASSERT(NULL != node);
-    while (current->left != NULL) {
-        current = current->left;
+    while (avl_node_left(current) != NULL) {
+        current = avl_node_left(current);
     }
     return current;
 }
 
+/**
+ * @brief Find node with maximum key in AVL-subtree.
+ *
+ * @param node Root node @ref avl_node_t of AVL-Tree.
+ * @return Node with maximum key.
+ */
+static inline avl_node_t *avl_node_find_max(avl_node_t *node) {
+    avl_node_t *current = node;
+    TEST_ASSERT(NULL != node);
+    while (avl_node_right(current) != NULL) {
+        current = avl_node_right(current);
+    }
+    return current;
+}
+
+#ifndef AVL_TREE_NODE_NO_PARENT
+/**
+ * @brief Find in-order successor of node.
+ *
+ * Walks parent links, no stack needed: O(1) amortized over a full traversal.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Node with the next greater key or NULL if node is the maximum.
+ */
+static inline avl_node_t *avl_node_next(avl_node_t *node) {
+    avl_node_t *current = node;
+    avl_node_t *next_node = NULL;
+    TEST_ASSERT(NULL != node);
+    if (NULL != avl_node_right(current)) {
+        next_node = avl_node_find_min(avl_node_right(current));
+    } else {
+        // Climb while coming from a right subtree.
+        next_node = avl_node_parent(current);
+        while ((NULL != next_node) && (avl_node_right(next_node) == current)) {
+            current = next_node;
+            next_node = avl_node_parent(next_node);
+        }
+    }
+    return next_node;
+}
+
+/**
+ * @brief Find in-order predecessor of node.
+ *
+ * Walks parent links, no stack needed: O(1) amortized over a full traversal.
+ *
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Node with the next smaller key or NULL if node is the minimum.
+ */
+static inline avl_node_t *avl_node_prev(avl_node_t *node) {
+    avl_node_t *current = node;
+    avl_node_t *prev_node = NULL;
+    TEST_ASSERT(NULL != node);
+    if (NULL != avl_node_left(current)) {
+        prev_node = avl_node_find_max(avl_node_left(current));
+    } else {
+        // Climb while coming from a left subtree.
+        prev_node = avl_node_parent(current);
+        while ((NULL != prev_node) && (avl_node_left(prev_node) == current)) {
+            current = prev_node;
+            prev_node = avl_node_parent(prev_node);
+        }
+    }
+    return prev_node;
+}
+#endif
+
 /**
  * @brief Recalculate height of node's subtree.
  *
  * This function relies on the height of the left and right subtrees being correct.
+ * With AVL_TREE_ORDER_STATISTICS the subtree size is recalculated as well.
+ * With AVL_TREE_NODE_BALANCE_FACTOR there is no height to store, only the size is updated:
+ * balance factors are maintained by the rebalancing walks.
  *
  * @param node AVL-Tree node @ref avl_node_t.
  */
 static inline void avl_node_height_calc(avl_node_t *node) {
-    avl_height_t left_height = avl_node_height(node->left);
-    avl_height_t right_height = avl_node_height(node->right);
+#ifndef AVL_TREE_NODE_BALANCE_FACTOR
+    avl_height_t left_height = avl_node_height(avl_node_left(node));
+    avl_height_t right_height = avl_node_height(avl_node_right(node));
     node->height = ((left_height > right_height) ? left_height : right_height) + 1;
+#endif
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_node_size_calc(node);
+#else
+    (void)node;
+#endif
 }
 
 /**
- * @brief Update parent of node.
+ * @brief Initialize balance information of node from the heights of its subtrees.
  *
- * @param curr_root AVL-Tree node @ref avl_node_t.
- * @param new_root New root node @ref avl_node_t.
+ * @param node AVL-Tree node @ref avl_node_t with children already linked.
+ * @param left_height Height of the left subtree.
+ * @param right_height Height of the right subtree, differs by at most 1.
+ */
+static inline void avl_node_balance_init(avl_node_t *node, int32_t left_height,
+                                         int32_t right_height) {
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    avl_node_set_balance_factor(node, right_height - left_height);
+#else
+    (void)left_height;
+    (void)right_height;
+#endif
+    avl_node_height_calc(node);
+}
+
+/**
+ * @brief Replace child of parent.
+ *
+ * @param parent AVL-Tree node @ref avl_node_t, may be NULL.
+ * @param old_node Current child node @ref avl_node_t.
+ * @param new_node New child node @ref avl_node_t.
  */
-static inline void avl_node_parent_update(avl_node_t *old_node, avl_node_t *new_node) {
-    if (NULL != new_node->parent) {
-        if (new_node->parent->left == old_node) {
-            new_node->parent->left = new_node;
-        } else if (new_node->parent->right == old_node) {
-            new_node->parent->right = new_node;
+static inline void avl_node_child_replace(avl_node_t *parent, avl_node_t *old_node,
+                                          avl_node_t *new_node) {
+    if (NULL != parent) {
+        if (avl_node_left(parent) == old_node) {
+            avl_node_set_left(parent, new_node);
+        } else if (avl_node_right(parent) == old_node) {
+            avl_node_set_right(parent, new_node);
         }
     }
 }
 
 /**
- * @brief Rotate node to the right.
+ * @brief Rotate the child of node in direction dir up into the place of node.
  *
+ * @param parent Parent node @ref avl_node_t of curr_root, NULL for the tree root.
  * @param curr_root AVL-Tree node @ref avl_node_t.
+ * @param dir Direction @ref avl_dir_t of the child becoming the new root.
  * @return New root node.
  */
-static inline avl_node_t *avl_node_rotate_right(avl_node_t *curr_root) {
+static inline avl_node_t *avl_node_rotate(avl_node_t *parent, avl_node_t *curr_root,
+                                          avl_dir_t dir) {
     TEST_ASSERT(NULL != curr_root);
-    TEST_PRINTF("rotate right @ %lu\n", curr_root->key);
-    avl_node_t *new_root = curr_root->left;
-    curr_root->left = new_root->right;
-    if (new_root->right != NULL) {
-        new_root->right->parent = curr_root;
-    }
-    new_root->right = curr_root;
-    new_root->parent = curr_root->parent;
-    curr_root->parent = new_root;
-    avl_node_parent_update(curr_root, new_root);
+    TEST_PRINTF("rotate %s @ %p\n", (AVL_DIR_LEFT == dir) ? "right" : "left", (void *)curr_root);
+    avl_dir_t opposite = dir ^ 1U;
+    avl_node_t *new_root = avl_node_child(curr_root, dir);
+    avl_node_t *inner = avl_node_child(new_root, opposite);
+    avl_node_set_child(curr_root, dir, inner);
+    if (inner != NULL) {
+        avl_node_set_parent(inner, curr_root);
+    }
+    avl_node_set_child(new_root, opposite, curr_root);
+    avl_node_set_parent(new_root, parent);
+    avl_node_set_parent(curr_root, new_root);
+    avl_node_child_replace(parent, curr_root, new_root);
     avl_node_height_calc(curr_root);
     avl_node_height_calc(new_root);
     return new_root;
 }
 
+/**
+ * @brief Rotate node to the right.
+ *
+ * @param parent Parent node @ref avl_node_t of curr_root, NULL for the tree root.
+ * @param curr_root AVL-Tree node @ref avl_node_t.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_rotate_right(avl_node_t *parent, avl_node_t *curr_root) {
+    return avl_node_rotate(parent, curr_root, AVL_DIR_LEFT);
+}
+
 /**
  * @brief Rotate node to the left.
  *
+ * @param parent Parent node @ref avl_node_t of curr_root, NULL for the tree root.
  * @param curr_root AVL-Tree node @ref avl_node_t.
  * @return New root node.
  */
-static inline avl_node_t *avl_node_rotate_left(avl_node_t *curr_root) {
-    TEST_ASSERT(NULL != curr_root);
-    TEST_PRINTF("rotate left @ %lu\n", curr_root->key);
-    avl_node_t *new_root = curr_root->right;
-    curr_root->right = new_root->left;
-    if (new_root->left != NULL) {
-        new_root->left->parent = curr_root;
-    }
-    new_root->left = curr_root;
-    new_root->parent = curr_root->parent;
-    curr_root->parent = new_root;
-    avl_node_parent_update(curr_root, new_root);
-    avl_node_height_calc(curr_root);
-    avl_node_height_calc(new_root);
-    return new_root;
+static inline avl_node_t *avl_node_rotate_left(avl_node_t *parent, avl_node_t *curr_root) {
+    return avl_node_rotate(parent, curr_root, AVL_DIR_RIGHT);
 }
 
+#ifndef AVL_TREE_NODE_BALANCE_FACTOR
 /**
  * @brief Balance node.
  *
+ * @param parent Parent node @ref avl_node_t of node, NULL for the tree root.
  * @param node AVL-Tree node @ref avl_node_t.
  * @return New root node.
  */
-static inline avl_node_t *avl_node_balance(avl_node_t *node) {
+static inline avl_node_t *avl_node_balance(avl_node_t *parent, avl_node_t *node) {
     TEST_ASSERT(NULL != node);
-    TEST_PRINTF("balance @ %lu\n", node->key);
+    TEST_PRINTF("balance @ %p\n", (void *)node);
     avl_node_t *new_root_node = node;
     avl_node_height_calc(node);
     if (avl_node_balance_factor(node) == 2) {
-        if (avl_node_balance_factor(node->right) < 0) {
-            node->right = avl_node_rotate_right(node->right);
+        if (avl_node_balance_factor(avl_node_right(node)) < 0) {
+            (void)avl_node_rotate_right(node, avl_node_right(node));
         }
-        new_root_node = avl_node_rotate_left(node);
+        new_root_node = avl_node_rotate_left(parent, node);
     }
     if (avl_node_balance_factor(node) == -2) {
-        if (avl_node_balance_factor(node->left) > 0) {
-            node->left = avl_node_rotate_left(node->left);
+        if (avl_node_balance_factor(avl_node_left(node)) > 0) {
+            (void)avl_node_rotate_left(node, avl_node_left(node));
         }
-        new_root_node = avl_node_rotate_right(node);
+        new_root_node = avl_node_rotate_right(parent, node);
     }
     return new_root_node;
 }
 
+#ifndef AVL_TREE_NODE_NO_PARENT
 /**
- * @brief Find node with key in AVL-Tree.
+ * @brief Rebalance AVL-Tree walking from node towards the root.
  *
- * @param node Root node @ref avl_node_t of AVL-Tree.
- * @param key Unique key of node @ref avl_key_t.
- * @return Node with key or NULL if not found.
+ * The walk stops as soon as a subtree keeps its previous height: nodes above it are unaffected.
+ * This relies on the heights stored along the path being the ones before the modification.
+ * With AVL_TREE_ORDER_STATISTICS only the subtree sizes are updated above that point.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree, returned if the walk stops early.
+ * @param node AVL-Tree node @ref avl_node_t to start from, may be NULL.
+ * @return New root node.
  */
-static inline avl_node_t *avl_tree_node_lookup(avl_node_t *node, avl_key_t key) {
+static inline avl_node_t *avl_node_rebalance_up(avl_node_t *root_node, avl_node_t *node) {
+    avl_node_t *new_root_node = root_node;
     avl_node_t *current = node;
-    avl_node_t *node_found = NULL;
-    avl_node_t tmp_node = {.left = NULL, .right = NULL, .parent = NULL, .height = 0, .key = key};
-    while ((NULL == node_found) && (NULL != current)) {
-        switch (avl_node_cmp(&tmp_node, current)) {
-        case AVL_CMP_LT:
-            current = current->left;
-            break;
-        case AVL_CMP_GT:
-            current = current->right;
-            break;
-        case AVL_CMP_EQ:
-            node_found = current;
-            break;
-        default:
-            TEST_ASSERT(false); // must never happen
-            break;
+    uint32_t levels = 0;
+    while (NULL != current) {
+        avl_node_t *parent = avl_node_parent(current);
+        avl_height_t old_height = current->height;
+        avl_node_t *subtree_root = avl_node_balance(parent, current);
+        levels++;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
+            current = NULL;
+        } else if (subtree_root->height == old_height) {
+#ifdef AVL_TREE_ORDER_STATISTICS
+            avl_node_size_path_update(parent);
+#endif
+            current = NULL;
+        } else {
+            current = parent;
         }
     }
-    return node_found;
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
+    return new_root_node;
 }
 
 /**
- * @brief Insert a node into AVL-Tree.
- * @note If key already exists, the function does nothing.
+ * @brief Rebalance AVL-Tree after the subtree of node grew by one level.
  *
- * @param root_node A root node @ref avl_node_t in a AVL-Tree.
- * @param new_node New node @ref avl_node_t to insert.
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t whose subtree grew, linked to its parent.
  * @return New root node.
  */
-static inline avl_node_t *avl_tree_node_insert(avl_node_t *root_node, avl_node_t *new_node) {
-    bool key_exists = false;
-    avl_node_t *parent = NULL;
-    avl_node_t *current = root_node;
-    avl_node_t *new_root_node = new_node; // automatically covers the empty tree case
-    avl_node_height_calc(new_node);
-
-    // Find the parent of the new node.
-    while (NULL != current || key_exists) {
-        parent = current;
+static inline avl_node_t *avl_node_retrace_grow(avl_node_t *root_node, avl_node_t *node) {
+    return avl_node_rebalance_up(root_node, avl_node_parent(node));
+}
 
-        switch (avl_node_cmp(new_node, current)) {
-        case AVL_CMP_LT:
-            current = current->left;
-            break;
-        case AVL_CMP_GT:
-            current = current->right;
-            break;
-        case AVL_CMP_EQ:
-            // Key already exists.
-            TEST_ASSERT(new_node->key != current->key);
-            new_root_node = root_node;
-            key_exists = true;
-            break;
-        default:
-            TEST_ASSERT(false); // must never happen
-            break;
+/**
+ * @brief Rebalance AVL-Tree after a subtree of node shrank by one level.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t whose child subtree shrank, may be NULL.
+ * @param left_shrank The left subtree shrank, otherwise the right one.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_shrink(avl_node_t *root_node, avl_node_t *node,
+                                                  bool left_shrank) {
+    (void)left_shrank;
+    return avl_node_rebalance_up(root_node, node);
+}
+#else
+/**
+ * @brief Rebalance AVL-Tree walking the path from its last node towards the root.
+ *
+ * The walk stops as soon as a subtree keeps its previous height: nodes above it are unaffected.
+ * This relies on the heights stored along the path being the ones before the modification.
+ * With AVL_TREE_ORDER_STATISTICS the subtree sizes along the whole path are updated first.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree, returned if the walk stops early.
+ * @param path Path @ref avl_node_path_t from the root to the node to start from, may be empty.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_rebalance_path(avl_node_t *root_node,
+                                                  const avl_node_path_t *path) {
+    avl_node_t *new_root_node = root_node;
+    uint32_t depth = path->depth;
+    uint32_t levels = 0;
+    bool done = false;
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_node_path_size_update(path);
+#endif
+    while (!done && (depth > 0U)) {
+        avl_node_t *current = path->nodes[depth - 1U];
+        avl_node_t *parent = (depth > 1U) ? path->nodes[depth - 2U] : NULL;
+        avl_height_t old_height = current->height;
+        avl_node_t *subtree_root = avl_node_balance(parent, current);
+        levels++;
+        depth--;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
+        } else if (subtree_root->height == old_height) {
+            done = true;
         }
     }
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
+    return new_root_node;
+}
 
-    // Insert the new node.
-    if (!key_exists) {
-        TEST_PRINTF("parent of %s will be %s\n", avl_node_to_str(new_node),
-                    avl_node_to_str(parent));
-        new_node->parent = parent;
+/**
+ * @brief Rebalance AVL-Tree after the subtree of node grew by one level.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param path Path @ref avl_node_path_t from the root to the parent of node.
+ * @param node AVL-Tree node @ref avl_node_t whose subtree grew, linked to its parent.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_grow(avl_node_t *root_node,
+                                                const avl_node_path_t *path, avl_node_t *node) {
+    (void)node;
+    return avl_node_rebalance_path(root_node, path);
+}
 
-        // Insert the new node.
-        if (NULL != parent) {
-            switch (avl_node_cmp(new_node, parent)) {
-            case AVL_CMP_LT:
-                TEST_ASSERT(NULL == parent->left);
-                parent->left = new_node;
-                break;
-            case AVL_CMP_GT:
-                TEST_ASSERT(NULL == parent->right);
-                parent->right = new_node;
-                break;
-            case AVL_CMP_EQ:
-            default:
-                TEST_ASSERT(false); // must never happen
-                break;
-            }
+/**
+ * @brief Rebalance AVL-Tree after a subtree of the last node of path shrank by one level.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param path Path @ref avl_node_path_t from the root to the node whose subtree shrank.
+ * @param left_shrank The left subtree shrank, otherwise the right one.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_shrink(avl_node_t *root_node,
+                                                  const avl_node_path_t *path, bool left_shrank) {
+    (void)left_shrank;
+    return avl_node_rebalance_path(root_node, path);
+}
+#endif
+#else
+/**
+ * @brief Balance node whose balance factor would become 2 or -2.
+ *
+ * The out of range balance factor is never stored: it is given by the side of the higher
+ * subtree, the balance factors of all rotated nodes are set from the known cases.
+ *
+ * @param parent Parent node @ref avl_node_t of node, NULL for the tree root.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @param right_heavy Right subtree is two levels higher, otherwise the left one.
+ * @return New root node, its balance factor is 0 if the subtree lost a level by the rotation.
+ */
+static inline avl_node_t *avl_node_balance_heavy(avl_node_t *parent, avl_node_t *node,
+                                                 bool right_heavy) {
+    avl_dir_t dir = right_heavy ? AVL_DIR_RIGHT : AVL_DIR_LEFT;
+    avl_node_t *child = avl_node_child(node, dir);
+    int32_t sign = right_heavy ? 1 : -1;
+    int32_t child_balance = avl_node_balance_factor(child) * sign;
+    avl_node_t *new_root_node = NULL;
+    TEST_PRINTF("balance @ %p\n", (void *)node);
+
+    if (child_balance < 0) {
+        // Double rotation, the grandchild becomes the root of the subtree.
+        avl_node_t *grandchild = avl_node_child(child, dir ^ 1U);
+        int32_t grandchild_balance = avl_node_balance_factor(grandchild) * sign;
+        (void)avl_node_rotate(node, child, dir ^ 1U);
+        new_root_node = avl_node_rotate(parent, node, dir);
+        avl_node_set_balance_factor(node, (grandchild_balance > 0) ? -sign : 0);
+        avl_node_set_balance_factor(child, (grandchild_balance < 0) ? sign : 0);
+        avl_node_set_balance_factor(grandchild, 0);
+    } else {
+        new_root_node = avl_node_rotate(parent, node, dir);
+        // A balanced child only happens on removal, the subtree keeps its height then.
+        avl_node_set_balance_factor(node, (0 == child_balance) ? sign : 0);
+        avl_node_set_balance_factor(child, (0 == child_balance) ? -sign : 0);
+    }
+    return new_root_node;
+}
+
+/**
+ * @brief Update node after one of its subtrees grew by one level.
+ *
+ * @param parent Parent node @ref avl_node_t of node, NULL for the tree root.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @param right_grew The right subtree grew, otherwise the left one.
+ * @param subtree_root Output: root node of the subtree, differs from node after a rotation.
+ * @return True if the subtree of node grew as well, the walk goes on.
+ */
+static inline bool avl_node_grow_level(avl_node_t *parent, avl_node_t *node, bool right_grew,
+                                       avl_node_t **subtree_root) {
+    int32_t balance_factor = avl_node_balance_factor(node) + (right_grew ? 1 : -1);
+    bool grew = false;
+    *subtree_root = node;
+    if ((1 == balance_factor) || (-1 == balance_factor)) {
+        avl_node_set_balance_factor(node, balance_factor);
+        grew = true;
+    } else if (0 == balance_factor) {
+        avl_node_set_balance_factor(node, 0);
+    } else {
+        *subtree_root = avl_node_balance_heavy(parent, node, right_grew);
+    }
+    return grew;
+}
+
+/**
+ * @brief Update node after one of its subtrees shrank by one level.
+ *
+ * @param parent Parent node @ref avl_node_t of node, NULL for the tree root.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @param left_shrank The left subtree shrank, otherwise the right one.
+ * @param subtree_root Output: root node of the subtree, differs from node after a rotation.
+ * @return True if the subtree of node shrank as well, the walk goes on.
+ */
+static inline bool avl_node_shrink_level(avl_node_t *parent, avl_node_t *node, bool left_shrank,
+                                         avl_node_t **subtree_root) {
+    int32_t balance_factor = avl_node_balance_factor(node) + (left_shrank ? 1 : -1);
+    bool shrank = true;
+    *subtree_root = node;
+    if ((1 == balance_factor) || (-1 == balance_factor)) {
+        avl_node_set_balance_factor(node, balance_factor);
+        shrank = false;
+    } else if (0 == balance_factor) {
+        avl_node_set_balance_factor(node, 0);
+    } else {
+        *subtree_root = avl_node_balance_heavy(parent, node, balance_factor > 0);
+        shrank = (0 == avl_node_balance_factor(*subtree_root));
+    }
+    return shrank;
+}
+
+#ifndef AVL_TREE_NODE_NO_PARENT
+/**
+ * @brief Rebalance AVL-Tree after the subtree of node grew by one level.
+ *
+ * Walks towards the root updating balance factors, it stops at the first ancestor that
+ * becomes balanced or after the first rotation.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t whose subtree grew, linked to its parent.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_grow(avl_node_t *root_node, avl_node_t *node) {
+    avl_node_t *new_root_node = root_node;
+    avl_node_t *child = node;
+    avl_node_t *current = avl_node_parent(node);
+    uint32_t levels = 0;
+    while (NULL != current) {
+        avl_node_t *parent = avl_node_parent(current);
+        avl_node_t *subtree_root = NULL;
+        bool right_grew = (avl_node_right(current) == child);
+        bool grew = avl_node_grow_level(parent, current, right_grew, &subtree_root);
+        levels++;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
         }
+        child = current;
+        current = grew ? parent : NULL;
+    }
+#ifdef AVL_TREE_ORDER_STATISTICS
+    // Rotated nodes off the path have their sizes set, all others are on the path to the root.
+    avl_node_size_path_update(node);
+#endif
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
+    return new_root_node;
+}
 
-        // Rebalance the tree, searching for the new root node.
-        current = new_node;
-        while (current != NULL) {
-            new_root_node = avl_node_balance(current);
-            TEST_PRINTF("new root = %lu\n", new_root_node->key);
-            current = new_root_node->parent;
+/**
+ * @brief Rebalance AVL-Tree after a subtree of node shrank by one level.
+ *
+ * Walks towards the root updating balance factors, it stops at the first ancestor that keeps
+ * its height.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t whose child subtree shrank, may be NULL.
+ * @param left_shrank The left subtree shrank, otherwise the right one.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_shrink(avl_node_t *root_node, avl_node_t *node,
+                                                  bool left_shrank) {
+    avl_node_t *new_root_node = root_node;
+    avl_node_t *current = node;
+    bool left_side = left_shrank;
+    uint32_t levels = 0;
+    while (NULL != current) {
+        avl_node_t *parent = avl_node_parent(current);
+        avl_node_t *subtree_root = NULL;
+        bool shrank = avl_node_shrink_level(parent, current, left_side, &subtree_root);
+        levels++;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
+        } else if (shrank) {
+            left_side = (avl_node_left(parent) == subtree_root);
+        }
+        current = shrank ? parent : NULL;
+    }
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_node_size_path_update(node);
+#endif
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
+    return new_root_node;
+}
+#else
+/**
+ * @brief Rebalance AVL-Tree after the subtree of node grew by one level.
+ *
+ * Walks the path towards the root updating balance factors, it stops at the first ancestor that
+ * becomes balanced or after the first rotation.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param path Path @ref avl_node_path_t from the root to the parent of node.
+ * @param node AVL-Tree node @ref avl_node_t whose subtree grew, linked to its parent.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_retrace_grow(avl_node_t *root_node,
+                                                const avl_node_path_t *path, avl_node_t *node) {
+    avl_node_t *new_root_node = root_node;
+    avl_node_t *child = node;
+    uint32_t depth = path->depth;
+    uint32_t levels = 0;
+    bool grew = true;
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_node_path_size_update(path);
+#endif
+    while (grew && (depth > 0U)) {
+        avl_node_t *current = path->nodes[depth - 1U];
+        avl_node_t *parent = (depth > 1U) ? path->nodes[depth - 2U] : NULL;
+        avl_node_t *subtree_root = NULL;
+        bool right_grew = (avl_node_right(current) == child);
+        grew = avl_node_grow_level(parent, current, right_grew, &subtree_root);
+        levels++;
+        depth--;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
         }
+        child = current;
     }
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
     return new_root_node;
 }
 
 /**
- * @brief Remove a node from AVL-Tree.
+ * @brief Rebalance AVL-Tree after a subtree of the last node of path shrank by one level.
  *
- * @param root_node A root node @ref avl_node_t in a AVL-Tree.
- * @param key Key of node to remove @ref avl_key_t.
+ * Walks the path towards the root updating balance factors, it stops at the first ancestor that
+ * keeps its height.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param path Path @ref avl_node_path_t from the root to the node whose subtree shrank.
+ * @param left_shrank The left subtree shrank, otherwise the right one.
  * @return New root node.
  */
-static inline avl_node_t *avl_tree_remove_node(avl_node_t *root_node, avl_key_t key) {
+static inline avl_node_t *avl_node_retrace_shrink(avl_node_t *root_node,
+                                                  const avl_node_path_t *path, bool left_shrank) {
     avl_node_t *new_root_node = root_node;
-    avl_node_t *node_to_remove = avl_tree_node_lookup(root_node, key);
+    uint32_t depth = path->depth;
+    bool left_side = left_shrank;
+    uint32_t levels = 0;
+    bool shrank = true;
+#ifdef AVL_TREE_ORDER_STATISTICS
+    avl_node_path_size_update(path);
+#endif
+    while (shrank && (depth > 0U)) {
+        avl_node_t *current = path->nodes[depth - 1U];
+        avl_node_t *parent = (depth > 1U) ? path->nodes[depth - 2U] : NULL;
+        avl_node_t *subtree_root = NULL;
+        shrank = avl_node_shrink_level(parent, current, left_side, &subtree_root);
+        levels++;
+        depth--;
+        if (NULL == parent) {
+            new_root_node = subtree_root;
+        } else if (shrank) {
+            left_side = (avl_node_left(parent) == subtree_root);
+        }
+    }
+    TEST_PRINTF("rebalancing visited %u levels\n", levels);
+    AVL_TREE_REBALANCE_LEVELS_HOOK(levels);
+    return new_root_node;
+}
+#endif
+#endif
 
-    if (node_to_remove != NULL) {
-        avl_node_t *replacement_node = NULL;
-        avl_node_t *node_to_rebalance_from = NULL;
+/**
+ * @brief Find node by a search key of another type than @ref avl_key_t.
+ *
+ * Heterogeneous lookup: cmp compares the borrowed search key with the nodes directly. A
+ * constant cmp is inlined by the compiler, avl_tree_node_lookup() passes avl_node_key_cmp().
+ * With AVL_TREE_LOOKUP_PREFETCH both children are prefetched at every level, overlapping the
+ * cache misses of the next level with the comparison in trees larger than the cache.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param search_key Search key passed to cmp.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ * @return Node matching search_key or NULL if not found.
+ */
+static inline avl_node_t *avl_tree_node_find(avl_node_t *root_node, const void *search_key,
+                                             avl_node_search_cmp_t cmp) {
+    avl_node_t *current = root_node;
+    avl_node_t *node_found = NULL;
+    // The direction is an index, only the rarely taken match is a branch.
+    while ((NULL == node_found) && (NULL != current)) {
+#ifdef AVL_TREE_LOOKUP_PREFETCH
+        // Both children are requested before the comparison decides which one is needed.
+        AVL_TREE_PREFETCH(avl_node_left(current));
+        AVL_TREE_PREFETCH(avl_node_right(current));
+#endif
+        avl_node_cmp_result_t cmp_result = cmp(search_key, current);
+        if (AVL_CMP_EQ == cmp_result) {
+            node_found = current;
+        } else {
+            current = avl_node_child(current, avl_cmp_dir(cmp_result));
+        }
+    }
+    return node_found;
+}
 
-        TEST_PRINTF("Node %lu found\n", node_to_remove->key);
+/**
+ * @brief Find node with key in AVL-Tree.
+ *
+ * @param node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Unique key of node @ref avl_key_t.
+ * @return Node with key or NULL if not found.
+ */
+static inline avl_node_t *avl_tree_node_lookup(avl_node_t *node, avl_key_t key) {
+    return avl_tree_node_find(node, &key, avl_node_search_key_cmp);
+}
 
-        if (node_to_remove->right != NULL) {
-            TEST_PRINTF("Node has a right child, replacement node is min of the right subtree\n");
-            replacement_node = avl_node_find_min(node_to_remove->right);
-            TEST_PRINTF("replacement node is %lu\n", replacement_node->key);
+/**
+ * @brief Find nodes for a batch of keys, interleaving the descents to hide memory latency.
+ *
+ * Keys are processed in groups of AVL_TREE_LOOKUP_BATCH_GROUP descents advanced one level at a
+ * time in lockstep. The next node of each descent is prefetched and only visited after all other
+ * descents of the group made their step, so the cache misses of a group overlap.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param keys Keys to search for @ref avl_key_t.
+ * @param count Number of keys.
+ * @param nodes_out Output: node with key or NULL for every key, count entries.
+ */
+static inline void avl_tree_node_lookup_batch(avl_node_t *root_node, const avl_key_t *keys,
+                                              size_t count, avl_node_t **nodes_out) {
+    avl_node_t *cursor[AVL_TREE_LOOKUP_BATCH_GROUP];
+    for (size_t first = 0; first < count; first += AVL_TREE_LOOKUP_BATCH_GROUP) {
+        size_t group = count - first;
+        size_t active = 0;
+        if (group > AVL_TREE_LOOKUP_BATCH_GROUP) {
+            group = AVL_TREE_LOOKUP_BATCH_GROUP;
+        }
+        for (size_t i = 0; i < group; i++) {
+            cursor[i] = root_node;
+            nodes_out[first + i] = NULL;
+        }
+        active = (NULL == root_node) ? 0 : group;
 
-            // Remove the replacement node from its current position.
-            if (replacement_node->parent->left == replacement_node) {
-                replacement_node->parent->left = replacement_node->right;
-                if (replacement_node->right != NULL) {
-                    replacement_node->right->parent = replacement_node->parent;
-                }
-            } else {
-                replacement_node->parent->right = replacement_node->right;
-                if (replacement_node->right != NULL) {
-                    replacement_node->right->parent = replacement_node->parent;
+        while (active > 0) {
+            for (size_t i = 0; i < group; i++) {
+                avl_node_t *current = cursor[i];
+                if (NULL != current) {
+                    avl_node_cmp_result_t cmp_result = avl_node_key_cmp(&keys[first + i], current);
+                    if (AVL_CMP_EQ == cmp_result) {
+                        nodes_out[first + i] = current;
+                        current = NULL;
+                    } else {
+                        current = avl_node_child(current, avl_cmp_dir(cmp_result));
+                        AVL_TREE_PREFETCH(current);
+                    }
+                    if (NULL == current) {
+                        active--;
+                    }
+                    cursor[i] = current;
                 }
             }
+        }
+    }
+}
 
-            node_to_rebalance_from = (replacement_node->parent == node_to_remove)
-                                         ? replacement_node
-                                         : replacement_node->parent;
+/**
+ * @brief Find nodes for a batch of sorted keys by finger search from the previous key.
+ *
+ * The path to the previous key is kept with the entries it descends left from. Keys ascend, so
+ * the previous key bounds the key range of every path entry from below, the nearest left turn
+ * above an entry bounds it from above. The next key resumes at the deepest entry whose range still
+ * holds it, only left turns are compared on the way up. A batch of m keys costs O(m log(n/m + 1))
+ * instead of m full descents from the root.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param keys Keys to search for @ref avl_key_t, in ascending order, duplicates allowed.
+ * @param count Number of keys.
+ * @param nodes_out Output: node with key or NULL for every key, count entries.
+ */
+static inline void avl_tree_node_lookup_sorted(avl_node_t *root_node, const avl_key_t *keys,
+                                               size_t count, avl_node_t **nodes_out) {
+    avl_node_path_t path;
+    uint8_t left_turns[AVL_TREE_MAX_HEIGHT]; // depths of path entries the path descends left from
+    uint32_t left_turn_count = 0U;
+    path.depth = 0U;
+    for (size_t i = 0; i < count; i++) {
+        avl_node_t *current = root_node;
+        avl_node_t *node_found = NULL;
+        TEST_ASSERT((0 == i) || (NULL == nodes_out[i - 1U]) ||
+                    (AVL_CMP_LT != avl_node_key_cmp(&keys[i], nodes_out[i - 1U])));
 
-            // Replace node_to_remove with replacement_node.
-            replacement_node->left = node_to_remove->left;
-            if (replacement_node->left != NULL) {
-                replacement_node->left->parent = replacement_node;
+        // A left turn at a node not greater than key closes the ranges of all entries below it.
+        if (path.depth > 0U) {
+            path.depth--;
+            while ((left_turn_count > 0U) &&
+                   (AVL_CMP_LT != avl_node_key_cmp(&keys[i],
+                                                   path.nodes[left_turns[left_turn_count - 1U]]))) {
+                path.depth = left_turns[--left_turn_count];
             }
-            replacement_node->right = node_to_remove->right;
-            if (replacement_node->right != NULL) {
-                replacement_node->right->parent = replacement_node;
-            }
-            replacement_node->parent = node_to_remove->parent;
-        } else if (node_to_remove->left != NULL) {
-            TEST_PRINTF("Node has only a left child, the hight of left subtree: %u\n",
-                        avl_node_height(node_to_remove->left));
-            replacement_node = node_to_remove->left;
-            TEST_PRINTF("replacement node is %lu\n", replacement_node->key);
-            replacement_node->parent = node_to_remove->parent;
-            node_to_rebalance_from = replacement_node;
-        } else {
-            TEST_PRINTF("Node has no children, thus no replacement node\n");
-            node_to_rebalance_from = node_to_remove->parent;
-            replacement_node = NULL;
+            current = path.nodes[path.depth];
         }
 
-        // Adjust the parent of node_to_remove to point to the replacement_node.
-        if (node_to_remove->parent != NULL) {
-            if (node_to_remove->parent->left == node_to_remove) {
-                node_to_remove->parent->left = replacement_node;
+        // Descend, recording the path for the next key.
+        while ((NULL == node_found) && (NULL != current)) {
+            avl_node_cmp_result_t cmp_result = avl_node_key_cmp(&keys[i], current);
+            avl_node_path_push(&path, current);
+            if (AVL_CMP_EQ == cmp_result) {
+                node_found = current;
             } else {
-                node_to_remove->parent->right = replacement_node;
+                current = avl_node_child(current, avl_cmp_dir(cmp_result));
+                if ((AVL_CMP_LT == cmp_result) && (NULL != current)) {
+                    left_turns[left_turn_count++] = (uint8_t)(path.depth - 1U);
+                }
             }
-        } else {
-            // Node to remove was the root node.
-            new_root_node = replacement_node;
         }
+        nodes_out[i] = node_found;
+    }
+}
 
-        // Clean up the removed node.
-        node_to_remove->left = NULL;
-        node_to_remove->right = NULL;
-        node_to_remove->parent = NULL;
-
-        // Rebalance the tree starting from node_to_rebalance_from.
-        TEST_PRINTF("node to rebalance from: %s\n", avl_node_to_str(node_to_rebalance_from));
-        avl_node_t *current = node_to_rebalance_from;
-        while (current != NULL) {
-            new_root_node = avl_node_balance(current);
-            current = current->parent;
+/**
+ * @brief Find the closest node above or below a search key in a single descent.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param search_key Search key passed to cmp.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ * @param above Search the smallest node above search_key, otherwise the greatest node below it.
+ * @param inclusive A node matching search_key itself qualifies.
+ * @return Closest node or NULL if there is none.
+ */
+AVL_TREE_FORCE_INLINE avl_node_t *avl_tree_node_bound_by(avl_node_t *root_node,
+                                                         const void *search_key,
+                                                         avl_node_search_cmp_t cmp, bool above,
+                                                         bool inclusive) {
+    avl_node_t *current = root_node;
+    avl_node_t *candidate = NULL;
+    while (NULL != current) {
+        switch (cmp(search_key, current)) {
+        case AVL_CMP_LT:
+            candidate = above ? current : candidate;
+            current = avl_node_left(current);
+            break;
+        case AVL_CMP_GT:
+            candidate = above ? candidate : current;
+            current = avl_node_right(current);
+            break;
+        case AVL_CMP_EQ:
+            if (inclusive) {
+                candidate = current;
+                current = NULL;
+            } else {
+                current = above ? avl_node_right(current) : avl_node_left(current);
+            }
+            break;
+        default:
+            TEST_ASSERT(false); // must never happen
+            break;
         }
     }
+    return candidate;
+}
 
-    return new_root_node;
+/**
+ * @brief Find the closest node above or below key in a single descent.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to search for @ref avl_key_t.
+ * @param above Search the smallest node above key, otherwise the greatest node below key.
+ * @param inclusive A node with key itself qualifies.
+ * @return Closest node or NULL if there is none.
+ */
+static inline avl_node_t *avl_tree_node_bound(avl_node_t *root_node, avl_key_t key, bool above,
+                                              bool inclusive) {
+    return avl_tree_node_bound_by(root_node, &key, avl_node_search_key_cmp, above, inclusive);
+}
+
+/**
+ * @brief Find the first node with key not smaller than key.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Node or NULL if all keys are smaller.
+ */
+static inline avl_node_t *avl_tree_node_lower_bound(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_node_bound(root_node, key, true, true);
+}
+
+/**
+ * @brief Find the first node with key greater than key.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Node or NULL if no key is greater.
+ */
+static inline avl_node_t *avl_tree_node_upper_bound(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_node_bound(root_node, key, true, false);
+}
+
+/**
+ * @brief Find the node with the greatest key not greater than key.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Node or NULL if all keys are greater.
+ */
+static inline avl_node_t *avl_tree_node_floor(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_node_bound(root_node, key, false, true);
+}
+
+/**
+ * @brief Find the node with the smallest key not smaller than key.
+ *
+ * Alias of @ref avl_tree_node_lower_bound, named as the counterpart of @ref avl_tree_node_floor.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Node or NULL if all keys are smaller.
+ */
+static inline avl_node_t *avl_tree_node_ceiling(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_node_lower_bound(root_node, key);
+}
+
+/**
+ * @brief Find in-order neighbour of node in AVL-Tree.
+ *
+ * Follows parent links, or descends from the root ordering by node_cmp with
+ * AVL_TREE_NODE_NO_PARENT, O(log n).
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @param dir Direction @ref avl_dir_t, AVL_DIR_RIGHT for the successor.
+ * @return Neighbour node or NULL if node is the last one in direction dir.
+ */
+AVL_TREE_FORCE_INLINE avl_node_t *avl_tree_node_step_by(avl_node_t *root_node, avl_node_t *node,
+                                                        avl_node_search_cmp_t node_cmp,
+                                                        avl_dir_t dir) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+    return avl_tree_node_bound_by(root_node, node, node_cmp, AVL_DIR_RIGHT == dir, false);
+#else
+    (void)root_node;
+    (void)node_cmp;
+    return (AVL_DIR_RIGHT == dir) ? avl_node_next(node) : avl_node_prev(node);
+#endif
+}
+
+/**
+ * @brief Find in-order successor of node in AVL-Tree.
+ *
+ * Follows parent links, or descends from the root with AVL_TREE_NODE_NO_PARENT, O(log n).
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Node with the next greater key or NULL if node is the maximum.
+ */
+static inline avl_node_t *avl_tree_node_next(avl_node_t *root_node, avl_node_t *node) {
+    return avl_tree_node_step_by(root_node, node, avl_node_search_node_cmp, AVL_DIR_RIGHT);
 }
 
+/**
+ * @brief Find in-order predecessor of node in AVL-Tree.
+ *
+ * Follows parent links, or descends from the root with AVL_TREE_NODE_NO_PARENT, O(log n).
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t.
+ * @return Node with the next smaller key or NULL if node is the minimum.
+ */
+static inline avl_node_t *avl_tree_node_prev(avl_node_t *root_node, avl_node_t *node) {
+    return avl_tree_node_step_by(root_node, node, avl_node_search_node_cmp, AVL_DIR_LEFT);
+}
+
+/**
+ * @brief First node of AVL-Tree in key order.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree, may be NULL.
+ * @return Node with minimum key or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_first(avl_node_t *root_node) {
+    return (NULL == root_node) ? NULL : avl_node_find_min(root_node);
+}
+
+/**
+ * @brief Last node of AVL-Tree in key order.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree, may be NULL.
+ * @return Node with maximum key or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_last(avl_node_t *root_node) {
+    return (NULL == root_node) ? NULL : avl_node_find_max(root_node);
+}
+
+/**
+ * @brief Position of an ascending in-order walk, the part of a range iterator without keys.
+ *
+ * With AVL_TREE_NODE_NO_PARENT the pending nodes of the walk are kept in a path, like parent
+ * links they make every step O(1) amortized.
+ */
+typedef struct {
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_path_t path; ///< pending nodes, the one returned next on top, empty when exhausted
+#else
+    avl_node_t *current; ///< node returned next, NULL when the walk is exhausted
+#endif
+} avl_node_walk_t;
+
+/**
+ * @brief Start an in-order walk at the first node not smaller than a search key.
+ *
+ * @param walk Walk @ref avl_node_walk_t to initialize.
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param lo Search key passed to cmp.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ */
+static inline void avl_node_walk_begin(avl_node_walk_t *walk, avl_node_t *root_node,
+                                       const void *lo, avl_node_search_cmp_t cmp) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+    // Nodes not smaller than lo on the way down are pending, the first node ends on top.
+    avl_node_t *current = root_node;
+    walk->path.depth = 0U;
+    while (NULL != current) {
+        avl_node_cmp_result_t cmp_result = cmp(lo, current);
+        if (AVL_CMP_GT == cmp_result) {
+            current = avl_node_right(current);
+        } else {
+            avl_node_path_push(&walk->path, current);
+            current = (AVL_CMP_EQ == cmp_result) ? NULL : avl_node_left(current);
+        }
+    }
+#else
+    walk->current = avl_tree_node_bound_by(root_node, lo, cmp, true, true);
+#endif
+}
+
+/**
+ * @brief Return the current node of an in-order walk unless it is above a search key, advance.
+ *
+ * @param walk Walk @ref avl_node_walk_t started by @ref avl_node_walk_begin.
+ * @param hi Search key passed to cmp, the walk ends at the first node greater than hi.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ * @return Next node or NULL when the walk is exhausted.
+ */
+static inline avl_node_t *avl_node_walk_next(avl_node_walk_t *walk, const void *hi,
+                                             avl_node_search_cmp_t cmp) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_t *node = avl_node_path_top(&walk->path);
+#else
+    avl_node_t *node = walk->current;
+#endif
+    if ((NULL != node) && (AVL_CMP_LT == cmp(hi, node))) {
+        node = NULL;
+    }
+#ifdef AVL_TREE_NODE_NO_PARENT
+    if (NULL == node) {
+        walk->path.depth = 0U;
+    } else {
+        walk->path.depth--;
+        avl_node_path_push_left(&walk->path, avl_node_right(node));
+    }
+#else
+    walk->current = (NULL == node) ? NULL : avl_node_next(node);
+#endif
+    return node;
+}
+
+/** @brief Iterator over nodes with keys in a closed range, in ascending order. */
+typedef struct {
+    avl_node_walk_t walk; ///< position of the in-order walk
+    avl_key_t hi;         ///< upper bound of the range
+} avl_tree_range_t;
+
+/**
+ * @brief Start iterating over nodes with key in closed range [lo, hi].
+ *
+ * One descent finds the first node, see @ref avl_tree_range_next for the rest. A full range is
+ * a single in-order pass, O(log n + k) for k nodes.
+ *
+ * @param range Iterator @ref avl_tree_range_t to initialize.
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param lo Lower bound of range @ref avl_key_t.
+ * @param hi Upper bound of range @ref avl_key_t.
+ */
+static inline void avl_tree_range_begin(avl_tree_range_t *range, avl_node_t *root_node,
+                                        avl_key_t lo, avl_key_t hi) {
+    avl_node_walk_begin(&range->walk, root_node, &lo, avl_node_search_key_cmp);
+    range->hi = hi;
+}
+
+/**
+ * @brief Return the current node of a range iteration and advance.
+ *
+ * @param range Iterator @ref avl_tree_range_t started by @ref avl_tree_range_begin.
+ * @return Next node in range or NULL when the range is exhausted.
+ */
+static inline avl_node_t *avl_tree_range_next(avl_tree_range_t *range) {
+    return avl_node_walk_next(&range->walk, &range->hi, avl_node_search_key_cmp);
+}
+
+/**
+ * @brief Insert a node into AVL-Tree unless an equal node exists, ordering by node_cmp.
+ *
+ * A single descent either finds the node with the same key or the parent of the new node.
+ * The caller tells both cases apart by comparing node_out with new_node.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param new_node New node @ref avl_node_t to insert.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @param node_out Output: new_node if inserted, otherwise the node with the same key.
+ * @return New root node.
+ */
+AVL_TREE_FORCE_INLINE avl_node_t *avl_tree_node_insert_or_get_by(avl_node_t *root_node,
+                                                                 avl_node_t *new_node,
+                                                                 avl_node_search_cmp_t node_cmp,
+                                                                 avl_node_t **node_out) {
+    avl_node_cmp_result_t cmp_result = AVL_CMP_EQ;
+    avl_node_t *parent = NULL;
+    avl_node_t *current = root_node;
+    avl_node_t *node_found = NULL;
+    avl_node_t *new_root_node = root_node;
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_path_t path;
+    path.depth = 0U;
+#endif
+
+    // Find the parent of the new node or the node with the same key.
+    while ((NULL == node_found) && (NULL != current)) {
+        cmp_result = node_cmp(new_node, current);
+        if (AVL_CMP_EQ == cmp_result) {
+            node_found = current;
+        } else {
+#ifdef AVL_TREE_NODE_NO_PARENT
+            avl_node_path_push(&path, current);
+#endif
+            parent = current;
+            current = avl_node_child(current, avl_cmp_dir(cmp_result));
+        }
+    }
+
+    // Insert the new node on the side of the last comparison.
+    if (NULL == node_found) {
+        TEST_PRINTF("parent of %p will be %s\n", (void *)new_node, avl_node_to_str(parent));
+        avl_node_set_left(new_node, NULL);
+        avl_node_set_right(new_node, NULL);
+        avl_node_set_parent(new_node, parent);
+        avl_node_balance_init(new_node, 0, 0);
+        if (NULL != parent) {
+            TEST_ASSERT(NULL == avl_node_child(parent, avl_cmp_dir(cmp_result)));
+            avl_node_set_child(parent, avl_cmp_dir(cmp_result), new_node);
+        }
+
+        // Rebalance the tree, searching for the new root node.
+#ifdef AVL_TREE_NODE_NO_PARENT
+        new_root_node =
+            avl_node_retrace_grow((NULL == parent) ? new_node : root_node, &path, new_node);
+#else
+        new_root_node = avl_node_retrace_grow((NULL == parent) ? new_node : root_node, new_node);
+#endif
+        TEST_PRINTF("new root = %p\n", (void *)new_root_node);
+        node_found = new_node;
+    }
+    *node_out = node_found;
+    return new_root_node;
+}
+
+/**
+ * @brief Insert a node into AVL-Tree unless its key already exists.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param new_node New node @ref avl_node_t to insert.
+ * @param node_out Output: new_node if inserted, otherwise the node with the same key.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_tree_node_insert_or_get(avl_node_t *root_node, avl_node_t *new_node,
+                                                      avl_node_t **node_out) {
+    return avl_tree_node_insert_or_get_by(root_node, new_node, avl_node_search_node_cmp,
+                                          node_out);
+}
+
+/**
+ * @brief Insert a node into AVL-Tree.
+ * @note If key already exists, the function does nothing.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param new_node New node @ref avl_node_t to insert.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_tree_node_insert(avl_node_t *root_node, avl_node_t *new_node) {
+    avl_node_t *node = NULL;
+    avl_node_t *new_root_node = avl_tree_node_insert_or_get(root_node, new_node, &node);
+    TEST_ASSERT(node == new_node); // key already exists
+    return new_root_node;
+}
+
+#ifdef AVL_TREE_NODE_NO_PARENT
+/**
+ * @brief Record the path from the root down to node, node included.
+ *
+ * Without parent links node is searched from the root, comparing with the node itself.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t in the tree.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @param path Output: path @ref avl_node_path_t ending with node.
+ */
+static inline void avl_node_path_find_by(avl_node_t *root_node, avl_node_t *node,
+                                         avl_node_search_cmp_t node_cmp, avl_node_path_t *path) {
+    avl_node_t *current = root_node;
+    path->depth = 0U;
+    while ((NULL != current) && (current != node)) {
+        avl_node_path_push(path, current);
+        current = (AVL_CMP_LT == node_cmp(node, current)) ? avl_node_left(current)
+                                                           : avl_node_right(current);
+    }
+    TEST_ASSERT(current == node); // node must be in the tree
+    avl_node_path_push(path, node);
+}
+
+/**
+ * @brief Record the path from the root down to node, node included.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param node AVL-Tree node @ref avl_node_t in the tree.
+ * @param path Output: path @ref avl_node_path_t ending with node.
+ */
+static inline void avl_node_path_find(avl_node_t *root_node, avl_node_t *node,
+                                      avl_node_path_t *path) {
+    avl_node_path_find_by(root_node, node, avl_node_search_node_cmp, path);
+}
+#endif
+
+/**
+ * @brief Remove a node from AVL-Tree, its parent known from a link or from a recorded path.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param node_to_remove Node @ref avl_node_t in the AVL-Tree to remove.
+ * @param path Path @ref avl_node_path_t from the root to node_to_remove with
+ *             AVL_TREE_NODE_NO_PARENT, reused for rebalancing. Not used otherwise, may be NULL.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_node_remove(avl_node_t *root_node, avl_node_t *node_to_remove,
+                                          avl_node_path_t *path) {
+    avl_node_t *new_root_node = root_node;
+    avl_node_t *replacement_node = NULL;
+    avl_node_t *node_to_rebalance_from = NULL;
+    TEST_ASSERT(NULL != node_to_remove);
+#ifdef AVL_TREE_NODE_NO_PARENT
+    TEST_ASSERT(avl_node_path_top(path) == node_to_remove);
+    uint32_t remove_depth = path->depth - 1U;
+    avl_node_t *remove_parent = (remove_depth > 0U) ? path->nodes[remove_depth - 1U] : NULL;
+#else
+    (void)path;
+    avl_node_t *remove_parent = avl_node_parent(node_to_remove);
+#endif
+    bool left_shrank = (NULL != remove_parent) && (avl_node_left(remove_parent) == node_to_remove);
+
+    TEST_PRINTF("Removing node %p\n", (void *)node_to_remove);
+
+    if (avl_node_right(node_to_remove) != NULL) {
+        TEST_PRINTF("Node has a right child, replacement node is min of the right subtree\n");
+        replacement_node = avl_node_right(node_to_remove);
+        while (NULL != avl_node_left(replacement_node)) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+            avl_node_path_push(path, replacement_node);
+#endif
+            replacement_node = avl_node_left(replacement_node);
+        }
+        TEST_PRINTF("replacement node is %p\n", (void *)replacement_node);
+
+        // Remove the replacement node from its current position.
+#ifdef AVL_TREE_NODE_NO_PARENT
+        avl_node_t *replacement_parent = avl_node_path_top(path);
+        // The replacement node takes the place of node_to_remove on the path.
+        path->nodes[remove_depth] = replacement_node;
+#else
+        avl_node_t *replacement_parent = avl_node_parent(replacement_node);
+#endif
+        avl_node_t *replacement_right = avl_node_right(replacement_node);
+        if (avl_node_left(replacement_parent) == replacement_node) {
+            avl_node_set_left(replacement_parent, replacement_right);
+        } else {
+            avl_node_set_right(replacement_parent, replacement_right);
+        }
+        if (replacement_right != NULL) {
+            avl_node_set_parent(replacement_right, replacement_parent);
+        }
+
+        node_to_rebalance_from =
+            (replacement_parent == node_to_remove) ? replacement_node : replacement_parent;
+        left_shrank = (replacement_parent != node_to_remove);
+
+        // Replace node_to_remove with replacement_node.
+        avl_node_set_left(replacement_node, avl_node_left(node_to_remove));
+        if (avl_node_left(replacement_node) != NULL) {
+            avl_node_set_parent(avl_node_left(replacement_node), replacement_node);
+        }
+        avl_node_set_right(replacement_node, avl_node_right(node_to_remove));
+        if (avl_node_right(replacement_node) != NULL) {
+            avl_node_set_parent(avl_node_right(replacement_node), replacement_node);
+        }
+        avl_node_set_parent(replacement_node, remove_parent);
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+        avl_node_set_balance_factor(replacement_node, avl_node_balance_factor(node_to_remove));
+#else
+        replacement_node->height = node_to_remove->height;
+#endif
+    } else if (avl_node_left(node_to_remove) != NULL) {
+        TEST_PRINTF("Node has only a left child, the hight of left subtree: %u\n",
+                    avl_node_height(avl_node_left(node_to_remove)));
+        replacement_node = avl_node_left(node_to_remove);
+        TEST_PRINTF("replacement node is %p\n", (void *)replacement_node);
+        avl_node_set_parent(replacement_node, remove_parent);
+        // The left subtree itself is unchanged, its former grandparent lost a level.
+        node_to_rebalance_from = remove_parent;
+    } else {
+        TEST_PRINTF("Node has no children, thus no replacement node\n");
+        node_to_rebalance_from = remove_parent;
+        replacement_node = NULL;
+    }
+
+    // Adjust the parent of node_to_remove to point to the replacement_node.
+    if (remove_parent != NULL) {
+        if (avl_node_left(remove_parent) == node_to_remove) {
+            avl_node_set_left(remove_parent, replacement_node);
+        } else {
+            avl_node_set_right(remove_parent, replacement_node);
+        }
+    } else {
+        // Node to remove was the root node.
+        new_root_node = replacement_node;
+    }
+
+    // Clean up the removed node.
+    avl_node_set_left(node_to_remove, NULL);
+    avl_node_set_right(node_to_remove, NULL);
+    avl_node_set_parent(node_to_remove, NULL);
+
+    // Rebalance the tree starting from node_to_rebalance_from.
+    TEST_PRINTF("node to rebalance from: %s\n", avl_node_to_str(node_to_rebalance_from));
+#ifdef AVL_TREE_NODE_NO_PARENT
+    // Unless replaced, node_to_remove leaves the path: its parent is the last node then.
+    if (node_to_rebalance_from == remove_parent) {
+        path->depth = remove_depth;
+    }
+    TEST_ASSERT(avl_node_path_top(path) == node_to_rebalance_from);
+    new_root_node = avl_node_retrace_shrink(new_root_node, path, left_shrank);
+#else
+    new_root_node = avl_node_retrace_shrink(new_root_node, node_to_rebalance_from, left_shrank);
+#endif
+    return new_root_node;
+}
+
+/**
+ * @brief Remove a node from AVL-Tree by pointer.
+ *
+ * The node is located through its parent pointer, with AVL_TREE_NODE_NO_PARENT by a descent
+ * from the root comparing with the node itself by node_cmp.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param node_to_remove Node @ref avl_node_t in the AVL-Tree to remove, may be NULL.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @return New root node.
+ */
+AVL_TREE_FORCE_INLINE avl_node_t *avl_tree_remove_node_ptr_by(avl_node_t *root_node,
+                                                              avl_node_t *node_to_remove,
+                                                              avl_node_search_cmp_t node_cmp) {
+    avl_node_t *new_root_node = root_node;
+    if (NULL != node_to_remove) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+        avl_node_path_t path;
+        avl_node_path_find_by(root_node, node_to_remove, node_cmp, &path);
+        new_root_node = avl_node_remove(root_node, node_to_remove, &path);
+#else
+        (void)node_cmp;
+        new_root_node = avl_node_remove(root_node, node_to_remove, NULL);
+#endif
+    }
+    return new_root_node;
+}
+
+/**
+ * @brief Remove a node from AVL-Tree by pointer.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param node_to_remove Node @ref avl_node_t in the AVL-Tree to remove, may be NULL.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_tree_remove_node_ptr(avl_node_t *root_node,
+                                                   avl_node_t *node_to_remove) {
+    return avl_tree_remove_node_ptr_by(root_node, node_to_remove, avl_node_search_node_cmp);
+}
+
+/**
+ * @brief Remove a node from AVL-Tree.
+ *
+ * @param root_node A root node @ref avl_node_t in a AVL-Tree.
+ * @param key Key of node to remove @ref avl_key_t.
+ * @return New root node.
+ */
+static inline avl_node_t *avl_tree_remove_node(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_remove_node_ptr(root_node, avl_tree_node_lookup(root_node, key));
+}
+
+/**
+ * @brief Recalculate cached data of AVL-Tree after its root was replaced.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ */
+static inline void avl_tree_cache_refresh(avl_tree_t *tree) {
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    tree->min = avl_tree_first(tree->root);
+    tree->max = avl_tree_last(tree->root);
+#else
+    (void)tree;
+#endif
+}
+
+/**
+ * @brief Insert a node into AVL-Tree unless an equal node exists, ordering by node_cmp.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param new_node New node @ref avl_node_t to insert.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @return new_node if inserted, otherwise the node with the same key.
+ */
+static inline avl_node_t *avl_tree_insert_by(avl_tree_t *tree, avl_node_t *new_node,
+                                             avl_node_search_cmp_t node_cmp) {
+    avl_node_t *node = NULL;
+    tree->root = avl_tree_node_insert_or_get_by(tree->root, new_node, node_cmp, &node);
+    if (node == new_node) {
+        tree->count++;
+    }
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    if (node == new_node) {
+        if ((NULL == tree->min) || (AVL_CMP_LT == node_cmp(new_node, tree->min))) {
+            tree->min = new_node;
+        }
+        if ((NULL == tree->max) || (AVL_CMP_GT == node_cmp(new_node, tree->max))) {
+            tree->max = new_node;
+        }
+    }
+#endif
+    return node;
+}
+
+/**
+ * @brief Insert a node into AVL-Tree unless its key already exists.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param new_node New node @ref avl_node_t to insert.
+ * @return new_node if inserted, otherwise the node with the same key.
+ */
+static inline avl_node_t *avl_tree_insert(avl_tree_t *tree, avl_node_t *new_node) {
+    return avl_tree_insert_by(tree, new_node, avl_node_search_node_cmp);
+}
+
+/**
+ * @brief Remove a node from AVL-Tree, locating it by node_cmp without parent links.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param node Node @ref avl_node_t in the tree to remove.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ */
+static inline void avl_tree_remove_by(avl_tree_t *tree, avl_node_t *node,
+                                      avl_node_search_cmp_t node_cmp) {
+    TEST_ASSERT(NULL != node);
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_path_t path;
+    avl_node_path_find_by(tree->root, node, node_cmp, &path);
+    avl_node_path_t *node_path = &path;
+#else
+    (void)node_cmp;
+    avl_node_path_t *node_path = NULL;
+#endif
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    if ((node == tree->min) || (node == tree->max)) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+        avl_node_t *parent = (path.depth > 1U) ? path.nodes[path.depth - 2U] : NULL;
+#else
+        avl_node_t *parent = avl_node_parent(node);
+#endif
+        // The minimum has no left subtree, its right one is a single node at most: the successor
+        // is that node or the parent. The same holds mirrored for the maximum.
+        if (node == tree->min) {
+            tree->min = (NULL != avl_node_right(node)) ? avl_node_right(node) : parent;
+        }
+        if (node == tree->max) {
+            tree->max = (NULL != avl_node_left(node)) ? avl_node_left(node) : parent;
+        }
+    }
+#endif
+    tree->root = avl_node_remove(tree->root, node, node_path);
+    TEST_ASSERT(tree->count > 0);
+    tree->count--;
+}
+
+/**
+ * @brief Remove a node from AVL-Tree.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param node Node @ref avl_node_t in the tree to remove.
+ */
+static inline void avl_tree_remove(avl_tree_t *tree, avl_node_t *node) {
+    avl_tree_remove_by(tree, node, avl_node_search_node_cmp);
+}
+
+/**
+ * @brief Remove the node with key from AVL-Tree.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param key Key of node to remove @ref avl_key_t.
+ * @return Removed node or NULL if not found.
+ */
+static inline avl_node_t *avl_tree_remove_key(avl_tree_t *tree, avl_key_t key) {
+    avl_node_t *node = avl_tree_node_lookup(tree->root, key);
+    if (NULL != node) {
+        avl_tree_remove(tree, node);
+    }
+    return node;
+}
+
+/**
+ * @brief Number of nodes in AVL-Tree, O(1).
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @return Number of nodes.
+ */
+static inline avl_size_t avl_tree_count(const avl_tree_t *tree) {
+    return tree->count;
+}
+
+/**
+ * @brief Node with minimum key, O(1) with AVL_TREE_CACHED_MIN_MAX.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @return Node with minimum key or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_peek_min(avl_tree_t *tree) {
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    return tree->min;
+#else
+    return avl_tree_first(tree->root);
+#endif
+}
+
+/**
+ * @brief Node with maximum key, O(1) with AVL_TREE_CACHED_MIN_MAX.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @return Node with maximum key or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_peek_max(avl_tree_t *tree) {
+#ifdef AVL_TREE_CACHED_MIN_MAX
+    return tree->max;
+#else
+    return avl_tree_last(tree->root);
+#endif
+}
+
+/**
+ * @brief Remove and return node with minimum key.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @return Removed node or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_pop_min(avl_tree_t *tree) {
+    avl_node_t *node = avl_tree_peek_min(tree);
+    if (NULL != node) {
+        avl_tree_remove(tree, node);
+    }
+    return node;
+}
+
+/**
+ * @brief Remove and return node with maximum key.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @return Removed node or NULL if the tree is empty.
+ */
+static inline avl_node_t *avl_tree_pop_max(avl_tree_t *tree) {
+    avl_node_t *node = avl_tree_peek_max(tree);
+    if (NULL != node) {
+        avl_tree_remove(tree, node);
+    }
+    return node;
+}
+
+/**
+ * @brief Join two AVL-Trees of known heights and a pivot node into one AVL-Tree.
+ *
+ * Works as @ref avl_tree_join with the heights provided by the caller, who receives the height
+ * of the joined tree in turn. No height is walked down, O(|h(left) - h(right)|) in all layouts.
+ *
+ * @param left Root node @ref avl_node_t of the AVL-Tree with smaller keys, may be NULL.
+ * @param left_height Height of left.
+ * @param pivot Detached node @ref avl_node_t to join the trees with.
+ * @param right Root node @ref avl_node_t of the AVL-Tree with greater keys, may be NULL.
+ * @param right_height Height of right.
+ * @param height Output: height of the joined tree.
+ * @return Root node of the joined tree.
+ */
+static inline avl_node_t *avl_node_join(avl_node_t *left, int32_t left_height, avl_node_t *pivot,
+                                        avl_node_t *right, int32_t right_height,
+                                        int32_t *height) {
+    avl_node_t *new_root_node = pivot;
+    avl_node_t *parent = NULL;
+    avl_node_t *current = NULL;
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    int32_t higher_height = (left_height > right_height) ? left_height : right_height;
+#endif
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_path_t path;
+    path.depth = 0U;
+#endif
+    TEST_ASSERT(NULL != pivot);
+    TEST_ASSERT((left_height == (int32_t)avl_node_height(left)) &&
+                (right_height == (int32_t)avl_node_height(right)));
+
+    if (NULL != left) {
+        avl_node_set_parent(left, NULL);
+    }
+    if (NULL != right) {
+        avl_node_set_parent(right, NULL);
+    }
+
+    // Heights along the spine follow from the balance factors, nothing else is read.
+    if (left_height > right_height + 1) {
+        // Descend the right spine of the left tree.
+        current = left;
+        while (left_height > right_height + 1) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+            avl_node_path_push(&path, current);
+#endif
+            parent = current;
+            left_height -= (avl_node_balance_factor(current) < 0) ? 2 : 1;
+            current = avl_node_right(current);
+        }
+        avl_node_set_right(parent, pivot);
+        avl_node_set_left(pivot, current);
+        avl_node_set_right(pivot, right);
+        new_root_node = left;
+    } else if (right_height > left_height + 1) {
+        // Descend the left spine of the right tree.
+        current = right;
+        while (right_height > left_height + 1) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+            avl_node_path_push(&path, current);
+#endif
+            parent = current;
+            right_height -= (avl_node_balance_factor(current) > 0) ? 2 : 1;
+            current = avl_node_left(current);
+        }
+        avl_node_set_left(parent, pivot);
+        avl_node_set_left(pivot, left);
+        avl_node_set_right(pivot, current);
+        new_root_node = right;
+    } else {
+        avl_node_set_left(pivot, left);
+        avl_node_set_right(pivot, right);
+    }
+
+    avl_node_set_parent(pivot, parent);
+    if (NULL != avl_node_left(pivot)) {
+        avl_node_set_parent(avl_node_left(pivot), pivot);
+    }
+    if (NULL != avl_node_right(pivot)) {
+        avl_node_set_parent(avl_node_right(pivot), pivot);
+    }
+    avl_node_balance_init(pivot, left_height, right_height);
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    avl_node_t *higher_root = new_root_node;
+    int32_t higher_balance = avl_node_balance_factor(higher_root);
+#endif
+#ifdef AVL_TREE_NODE_NO_PARENT
+    new_root_node = avl_node_retrace_grow(new_root_node, &path, pivot);
+#else
+    new_root_node = avl_node_retrace_grow(new_root_node, pivot);
+#endif
+
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    // The higher tree grew iff the growth passed its root: no rotation there and it lost balance.
+    if ((pivot == higher_root) ||
+        ((new_root_node == higher_root) && (0 == higher_balance) &&
+         (0 != avl_node_balance_factor(higher_root)))) {
+        higher_height++;
+    }
+    *height = higher_height;
+#else
+    *height = (int32_t)avl_node_height(new_root_node);
+#endif
+    return new_root_node;
+}
+
+/**
+ * @brief Join two AVL-Trees and a pivot node into one AVL-Tree.
+ *
+ * All keys in left must be smaller and all keys in right greater than the key of pivot.
+ * The pivot is linked in where the spine of the higher tree meets the height of the lower one,
+ * thus the function runs in O(|h(left) - h(right)|). With AVL_TREE_NODE_BALANCE_FACTOR finding
+ * the two heights adds O(log n), see @ref avl_node_join when they are known.
+ *
+ * @param left Root node @ref avl_node_t of the AVL-Tree with smaller keys, may be NULL.
+ * @param pivot Detached node @ref avl_node_t to join the trees with.
+ * @param right Root node @ref avl_node_t of the AVL-Tree with greater keys, may be NULL.
+ * @return Root node of the joined tree.
+ */
+static inline avl_node_t *avl_tree_join(avl_node_t *left, avl_node_t *pivot, avl_node_t *right) {
+    int32_t height = 0;
+    return avl_node_join(left, (int32_t)avl_node_height(left), pivot, right,
+                         (int32_t)avl_node_height(right), &height);
+}
+
+/**
+ * @brief Split AVL-Tree at a search key, reporting the heights of both parts.
+ *
+ * Works as @ref avl_tree_split. Every join gets the heights it needs: the accumulated trees
+ * report theirs, the heights of an ancestor and of its subtree off the search path follow from
+ * the subtree below on the path and the balance factor, a child is one or two levels lower.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param search_key Search key passed to cmp, to split at.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ * @param left Output: root node of the tree with smaller keys, NULL if empty.
+ * @param left_height Output: height of left.
+ * @param right Output: root node of the tree with greater keys, NULL if empty.
+ * @param right_height Output: height of right.
+ * @return Detached node matching search_key or NULL if not found.
+ */
+AVL_TREE_FORCE_INLINE avl_node_t *avl_node_split_by(avl_node_t *root_node, const void *search_key,
+                                                    avl_node_search_cmp_t cmp, avl_node_t **left,
+                                                    int32_t *left_height, avl_node_t **right,
+                                                    int32_t *right_height) {
+    avl_node_t *node_found = NULL;
+    avl_node_t *current = root_node;
+    avl_node_t *ancestor = NULL;
+    avl_node_t *left_root = NULL;
+    avl_node_t *right_root = NULL;
+    int32_t left_root_height = 0;
+    int32_t right_root_height = 0;
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+    int32_t path_height = 0; // height of the subtree below ancestor on the search path
+#endif
+#ifdef AVL_TREE_NODE_NO_PARENT
+    avl_node_path_t path;
+    path.depth = 0U;
+#endif
+    TEST_ASSERT((NULL != left) && (NULL != right));
+
+    // Find the node with key, ancestor ends as its parent or as the last node of the search path.
+    while ((NULL == node_found) && (NULL != current)) {
+        avl_node_cmp_result_t cmp_result = cmp(search_key, current);
+        if (AVL_CMP_EQ == cmp_result) {
+            node_found = current;
+        } else {
+#ifdef AVL_TREE_NODE_NO_PARENT
+            avl_node_path_push(&path, current);
+#endif
+            ancestor = current;
+            current = avl_node_child(current, avl_cmp_dir(cmp_result));
+        }
+    }
+
+    if (NULL != node_found) {
+        TEST_PRINTF("split @ %p\n", (void *)node_found);
+        left_root = avl_node_left(node_found);
+        right_root = avl_node_right(node_found);
+        // Measured once per split, every further height is derived.
+        left_root_height = (int32_t)avl_node_height(left_root);
+        right_root_height = (int32_t)avl_node_height(right_root);
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+        path_height =
+            1 + ((left_root_height > right_root_height) ? left_root_height : right_root_height);
+#endif
+        if (NULL != left_root) {
+            avl_node_set_parent(left_root, NULL);
+        }
+        if (NULL != right_root) {
+            avl_node_set_parent(right_root, NULL);
+        }
+        avl_node_set_left(node_found, NULL);
+        avl_node_set_right(node_found, NULL);
+        avl_node_set_parent(node_found, NULL);
+        avl_node_balance_init(node_found, 0, 0);
+    }
+
+    // Walk back up: the child on the search path is already distributed to the two trees.
+    while (NULL != ancestor) {
+#ifdef AVL_TREE_NODE_NO_PARENT
+        path.depth--;
+        avl_node_t *next_ancestor = avl_node_path_top(&path);
+#else
+        avl_node_t *next_ancestor = avl_node_parent(ancestor);
+#endif
+        avl_dir_t dir = avl_cmp_dir(cmp(search_key, ancestor));
+        avl_node_t *sibling = avl_node_child(ancestor, dir ^ 1U);
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+        // Read before the join resets it: positive if the search path side is the higher one.
+        int32_t path_balance = avl_node_balance_factor(ancestor);
+        path_balance = (AVL_DIR_RIGHT == dir) ? path_balance : -path_balance;
+        int32_t sibling_height = path_height - path_balance;
+        path_height += (path_balance < 0) ? 2 : 1;
+#else
+        int32_t sibling_height = (int32_t)avl_node_height(sibling);
+#endif
+        if (AVL_DIR_LEFT == dir) {
+            right_root = avl_node_join(right_root, right_root_height, ancestor, sibling,
+                                       sibling_height, &right_root_height);
+        } else {
+            left_root = avl_node_join(sibling, sibling_height, ancestor, left_root,
+                                      left_root_height, &left_root_height);
+        }
+        ancestor = next_ancestor;
+    }
+
+    *left = left_root;
+    *left_height = left_root_height;
+    *right = right_root;
+    *right_height = right_root_height;
+    return node_found;
+}
+
+/**
+ * @brief Split AVL-Tree at key, reporting the heights of both parts.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to split at @ref avl_key_t.
+ * @param left Output: root node of the tree with smaller keys, NULL if empty.
+ * @param left_height Output: height of left.
+ * @param right Output: root node of the tree with greater keys, NULL if empty.
+ * @param right_height Output: height of right.
+ * @return Detached node with key or NULL if not found.
+ */
+static inline avl_node_t *avl_node_split(avl_node_t *root_node, avl_key_t key, avl_node_t **left,
+                                         int32_t *left_height, avl_node_t **right,
+                                         int32_t *right_height) {
+    return avl_node_split_by(root_node, &key, avl_node_search_key_cmp, left, left_height, right,
+                             right_height);
+}
+
+/**
+ * @brief Split AVL-Tree at key.
+ *
+ * The tree is dismantled into a tree with all keys smaller than key, a tree with all keys
+ * greater than key and the node with key itself. Walking back up the search path, every
+ * ancestor is joined with its subtree on the far side of key, which sums up to O(log n).
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to split at @ref avl_key_t.
+ * @param left Output: root node of the tree with smaller keys, NULL if empty.
+ * @param right Output: root node of the tree with greater keys, NULL if empty.
+ * @return Detached node with key or NULL if not found.
+ */
+static inline avl_node_t *avl_tree_split(avl_node_t *root_node, avl_key_t key, avl_node_t **left,
+                                         avl_node_t **right) {
+    int32_t left_height = 0;
+    int32_t right_height = 0;
+    return avl_node_split(root_node, key, left, &left_height, right, &right_height);
+}
+
+/**
+ * @brief Join two AVL-Trees of known heights without a pivot node.
+ *
+ * Works as @ref avl_tree_join2 and reports the height of the joined tree. Removing the minimum
+ * lowers the right tree by up to one level, it is measured again, O(log n) as the removal itself.
+ *
+ * @param left Root node @ref avl_node_t of the AVL-Tree with smaller keys, may be NULL.
+ * @param left_height Height of left.
+ * @param right Root node @ref avl_node_t of the AVL-Tree with greater keys, may be NULL.
+ * @param right_height Height of right.
+ * @param height Output: height of the joined tree.
+ * @return Root node of the joined tree.
+ */
+static inline avl_node_t *avl_node_join2(avl_node_t *left, int32_t left_height, avl_node_t *right,
+                                         int32_t right_height, int32_t *height) {
+    avl_node_t *new_root_node = (NULL == left) ? right : left;
+    *height = (NULL == left) ? right_height : left_height;
+    if ((NULL != left) && (NULL != right)) {
+        avl_node_set_parent(right, NULL);
+#ifdef AVL_TREE_NODE_NO_PARENT
+        // The path to the minimum is the left spine, no comparison needed.
+        avl_node_path_t path;
+        path.depth = 0U;
+        avl_node_path_push_left(&path, right);
+        avl_node_t *pivot = avl_node_path_top(&path);
+        avl_node_t *right_rest = avl_node_remove(right, pivot, &path);
+#else
+        avl_node_t *pivot = avl_node_find_min(right);
+        avl_node_t *right_rest = avl_node_remove(right, pivot, NULL);
+#endif
+        new_root_node = avl_node_join(left, left_height, pivot, right_rest,
+                                      (int32_t)avl_node_height(right_rest), height);
+    }
+    return new_root_node;
+}
+
+/**
+ * @brief Join two AVL-Trees without a pivot node.
+ *
+ * The minimum of the right tree is detached and used as pivot, O(log n).
+ *
+ * @param left Root node @ref avl_node_t of the AVL-Tree with smaller keys, may be NULL.
+ * @param right Root node @ref avl_node_t of the AVL-Tree with greater keys, may be NULL.
+ * @return Root node of the joined tree.
+ */
+static inline avl_node_t *avl_tree_join2(avl_node_t *left, avl_node_t *right) {
+    int32_t height = 0;
+    return avl_node_join2(left, (int32_t)avl_node_height(left), right,
+                          (int32_t)avl_node_height(right), &height);
+}
+
+/** @brief Pending step of a set operation: a guide node whose subtrees are being merged. */
+typedef struct {
+    avl_node_t *guide;               ///< node of the guiding tree
+    avl_node_t *split_right;         ///< part of the split tree greater than the guide key
+    avl_node_t *found;               ///< node of the split tree with the guide key, or NULL
+    avl_node_t *left_in;             ///< result for the left subtree
+    avl_node_t *left_out;            ///< remainder for the left subtree
+    avl_height_t guide_right_height; ///< height of the right guide subtree
+    avl_height_t split_right_height; ///< height of split_right
+    avl_height_t left_in_height;     ///< height of left_in
+    avl_height_t left_out_height;    ///< height of left_out
+    bool left_done;                  ///< left subtree has been merged
+} avl_tree_set_frame_t;
+
+/**
+ * @brief Merge a split tree along the structure of a guide tree.
+ *
+ * For every guide node the split tree is split at its key and both halves are merged with the
+ * guide subtrees; results are combined with join. This is the recursive join-based algorithm
+ * running in O(m log(n/m + 1)), with the recursion kept in a bounded stack of frames. Heights
+ * are measured once at the roots and passed along with every tree, so that each join costs
+ * only the height difference with AVL_TREE_NODE_BALANCE_FACTOR as well.
+ *
+ * Union: guide nodes and split nodes with new keys form "in", split nodes whose key is already
+ * in the guide tree form "out".
+ * Partition: the guide tree is only read, split nodes whose key is in the guide tree form "in",
+ * the others form "out".
+ *
+ * @param guide Root node @ref avl_node_t of the guiding tree.
+ * @param split Root node @ref avl_node_t of the tree being split.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @param is_union Union, otherwise partition.
+ * @param in Output: root node of the result tree.
+ * @param out Output: root node of the remainder tree.
+ * @return Number of keys present in both trees.
+ */
+static inline avl_size_t avl_tree_set_merge(avl_node_t *guide, avl_node_t *split,
+                                            avl_node_search_cmp_t node_cmp, bool is_union,
+                                            avl_node_t **in, avl_node_t **out) {
+    avl_tree_set_frame_t stack[AVL_TREE_MAX_HEIGHT];
+    size_t depth = 0;
+    avl_size_t matches = 0;
+    avl_node_t *call_guide = guide;
+    avl_node_t *call_split = split;
+    avl_node_t *ret_in = NULL;
+    avl_node_t *ret_out = NULL;
+    int32_t call_guide_height = (int32_t)avl_node_height(guide);
+    int32_t call_split_height = (int32_t)avl_node_height(split);
+    int32_t ret_in_height = 0;
+    int32_t ret_out_height = 0;
+    bool calling = true;
+    bool done = false;
+
+    while (!done) {
+        if (calling && ((NULL == call_guide) || (NULL == call_split))) {
+            // One of the trees is empty, the other one is the result.
+            bool guide_empty = NULL == call_guide;
+            ret_in = is_union ? (guide_empty ? call_split : call_guide) : NULL;
+            ret_in_height = is_union ? (guide_empty ? call_split_height : call_guide_height) : 0;
+            ret_out = is_union ? NULL : call_split;
+            ret_out_height = is_union ? 0 : call_split_height;
+            calling = false;
+        } else if (calling) {
+            avl_node_t *split_left = NULL;
+            int32_t split_left_height = 0;
+            int32_t split_right_height = 0;
+            TEST_ASSERT(depth < AVL_TREE_MAX_HEIGHT);
+            avl_tree_set_frame_t *frame = &stack[depth++];
+            frame->guide = call_guide;
+            frame->found = avl_node_split_by(call_split, call_guide, node_cmp, &split_left,
+                                             &split_left_height, &frame->split_right,
+                                             &split_right_height);
+            frame->split_right_height = (avl_height_t)split_right_height;
+            // Guide subtrees are one or two levels lower, as told by the balance factor.
+            int32_t balance_factor = avl_node_balance_factor(call_guide);
+            frame->guide_right_height =
+                (avl_height_t)(call_guide_height - ((balance_factor < 0) ? 2 : 1));
+            frame->left_done = false;
+            call_guide = avl_node_left(call_guide);
+            call_guide_height -= (balance_factor > 0) ? 2 : 1;
+            call_split = split_left;
+            call_split_height = split_left_height;
+        } else if (0 == depth) {
+            done = true;
+        } else {
+            avl_tree_set_frame_t *frame = &stack[depth - 1];
+            if (!frame->left_done) {
+                frame->left_in = ret_in;
+                frame->left_in_height = (avl_height_t)ret_in_height;
+                frame->left_out = ret_out;
+                frame->left_out_height = (avl_height_t)ret_out_height;
+                frame->left_done = true;
+                call_guide = avl_node_right(frame->guide);
+                call_guide_height = frame->guide_right_height;
+                call_split = frame->split_right;
+                call_split_height = frame->split_right_height;
+                calling = true;
+            } else {
+                avl_node_t *in_pivot = is_union ? frame->guide : frame->found;
+                avl_node_t *out_pivot = is_union ? frame->found : NULL;
+                matches += (NULL != frame->found) ? 1 : 0;
+                ret_in = (NULL != in_pivot)
+                             ? avl_node_join(frame->left_in, frame->left_in_height, in_pivot,
+                                             ret_in, ret_in_height, &ret_in_height)
+                             : avl_node_join2(frame->left_in, frame->left_in_height, ret_in,
+                                              ret_in_height, &ret_in_height);
+                ret_out = (NULL != out_pivot)
+                              ? avl_node_join(frame->left_out, frame->left_out_height, out_pivot,
+                                              ret_out, ret_out_height, &ret_out_height)
+                              : avl_node_join2(frame->left_out, frame->left_out_height, ret_out,
+                                               ret_out_height, &ret_out_height);
+                depth--;
+            }
+        }
+    }
+
+    *in = ret_in;
+    *out = ret_out;
+    return matches;
+}
+
+/**
+ * @brief Move all nodes of other into tree, ordering by node_cmp.
+ *
+ * Nodes of other with a key already in tree are not moved, they end up in duplicates.
+ * Runs in O(m log(n/m + 1)) for tree sizes m <= n.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t receiving the union.
+ * @param other AVL-Tree @ref avl_tree_t sharing the node pool with tree, left empty.
+ * @param duplicates Output: AVL-Tree @ref avl_tree_t set to the rejected nodes, may be NULL.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @return Number of keys present in both trees.
+ */
+static inline avl_size_t avl_tree_union_by(avl_tree_t *tree, avl_tree_t *other,
+                                           avl_tree_t *duplicates,
+                                           avl_node_search_cmp_t node_cmp) {
+    avl_node_t *duplicates_root = NULL;
+    avl_size_t matches = avl_tree_set_merge(tree->root, other->root, node_cmp, true, &tree->root,
+                                            &duplicates_root);
+    tree->count += other->count - matches;
+    other->root = NULL;
+    other->count = 0;
+    avl_tree_cache_refresh(tree);
+    avl_tree_cache_refresh(other);
+    if (NULL != duplicates) {
+        duplicates->root = duplicates_root;
+        duplicates->count = matches;
+        avl_tree_cache_refresh(duplicates);
+    }
+    return matches;
+}
+
+/**
+ * @brief Keep only nodes of tree with a key present in other, ordering by node_cmp.
+ *
+ * Runs in O(m log(n/m + 1)) for tree sizes m <= n.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t to intersect.
+ * @param other AVL-Tree @ref avl_tree_t with the keys to keep, not modified.
+ * @param removed Output: AVL-Tree @ref avl_tree_t set to the removed nodes, may be NULL.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @return Number of nodes kept in tree.
+ */
+static inline avl_size_t avl_tree_intersection_by(avl_tree_t *tree, const avl_tree_t *other,
+                                                  avl_tree_t *removed,
+                                                  avl_node_search_cmp_t node_cmp) {
+    avl_node_t *removed_root = NULL;
+    avl_size_t matches = avl_tree_set_merge(other->root, tree->root, node_cmp, false, &tree->root,
+                                            &removed_root);
+    avl_size_t removed_count = tree->count - matches;
+    tree->count = matches;
+    avl_tree_cache_refresh(tree);
+    if (NULL != removed) {
+        removed->root = removed_root;
+        removed->count = removed_count;
+        avl_tree_cache_refresh(removed);
+    }
+    return matches;
+}
+
+/**
+ * @brief Remove nodes of tree with a key present in other, ordering by node_cmp.
+ *
+ * Runs in O(m log(n/m + 1)) for tree sizes m <= n.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t to subtract from.
+ * @param other AVL-Tree @ref avl_tree_t with the keys to remove, not modified.
+ * @param removed Output: AVL-Tree @ref avl_tree_t set to the removed nodes, may be NULL.
+ * @param node_cmp Comparison @ref avl_node_search_cmp_t with a node as search key.
+ * @return Number of nodes removed from tree.
+ */
+static inline avl_size_t avl_tree_difference_by(avl_tree_t *tree, const avl_tree_t *other,
+                                                avl_tree_t *removed,
+                                                avl_node_search_cmp_t node_cmp) {
+    avl_node_t *removed_root = NULL;
+    avl_size_t matches = avl_tree_set_merge(other->root, tree->root, node_cmp, false,
+                                            &removed_root, &tree->root);
+    tree->count -= matches;
+    avl_tree_cache_refresh(tree);
+    if (NULL != removed) {
+        removed->root = removed_root;
+        removed->count = matches;
+        avl_tree_cache_refresh(removed);
+    }
+    return matches;
+}
+
+/**
+ * @brief Move all nodes of other into tree, see @ref avl_tree_union_by.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t receiving the union.
+ * @param other AVL-Tree @ref avl_tree_t sharing the node pool with tree, left empty.
+ * @param duplicates Output: AVL-Tree @ref avl_tree_t set to the rejected nodes, may be NULL.
+ * @return Number of keys present in both trees.
+ */
+static inline avl_size_t avl_tree_union(avl_tree_t *tree, avl_tree_t *other,
+                                        avl_tree_t *duplicates) {
+    return avl_tree_union_by(tree, other, duplicates, avl_node_search_node_cmp);
+}
+
+/**
+ * @brief Keep only nodes of tree with a key present in other, see @ref avl_tree_intersection_by.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t to intersect.
+ * @param other AVL-Tree @ref avl_tree_t with the keys to keep, not modified.
+ * @param removed Output: AVL-Tree @ref avl_tree_t set to the removed nodes, may be NULL.
+ * @return Number of nodes kept in tree.
+ */
+static inline avl_size_t avl_tree_intersection(avl_tree_t *tree, const avl_tree_t *other,
+                                               avl_tree_t *removed) {
+    return avl_tree_intersection_by(tree, other, removed, avl_node_search_node_cmp);
+}
+
+/**
+ * @brief Remove nodes of tree with a key present in other, see @ref avl_tree_difference_by.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t to subtract from.
+ * @param other AVL-Tree @ref avl_tree_t with the keys to remove, not modified.
+ * @param removed Output: AVL-Tree @ref avl_tree_t set to the removed nodes, may be NULL.
+ * @return Number of nodes removed from tree.
+ */
+static inline avl_size_t avl_tree_difference(avl_tree_t *tree, const avl_tree_t *other,
+                                             avl_tree_t *removed) {
+    return avl_tree_difference_by(tree, other, removed, avl_node_search_node_cmp);
+}
+
+#ifndef AVL_TREE_NODE_KEY_OFFSET
+/** @brief Stack depth for building a tree: height of a perfectly balanced tree plus one. */
+#define AVL_TREE_BUILD_STACK_SIZE ((sizeof(avl_size_t) * CHAR_BIT) + 1U)
+
+/** @brief Pending subtree of a tree being built from a sorted array. */
+typedef struct {
+    avl_node_t *parent; ///< node the subtree root is linked to, NULL for the tree root
+    avl_size_t first;   ///< index of the first node of the subtree
+    avl_size_t count;   ///< number of nodes in the subtree, never 0
+    avl_height_t height;
+    bool is_right; ///< subtree is the right child of parent
+} avl_tree_build_range_t;
+
+/**
+ * @brief Build a perfectly balanced AVL-Tree from a sorted node array, not with key offset.
+ *
+ * The keys of the array elements are read, with AVL_TREE_NODE_KEY_OFFSET they live outside of
+ * the array in containers, so the function is not declared then.
+ * Runs in O(n) without rotations. Links, heights (and sizes) of all nodes are overwritten.
+ *
+ * @param nodes Array of nodes @ref avl_node_t sorted by ascending key, no duplicates.
+ * @param count Number of nodes in the array.
+ * @return Root node of the new tree or NULL if count is 0.
+ */
+static inline avl_node_t *avl_tree_build_sorted(avl_node_t *nodes, avl_size_t count) {
+    avl_node_t *root_node = NULL;
+    avl_tree_build_range_t stack[AVL_TREE_BUILD_STACK_SIZE];
+    size_t depth = 0;
+
+    if (count > 0) {
+        avl_height_t height = 0;
+        avl_size_t remaining = count;
+        while (remaining > 0) {
+            height++;
+            remaining >>= 1U;
+        }
+        stack[depth++] = (avl_tree_build_range_t){
+            .parent = NULL, .first = 0, .count = count, .height = height, .is_right = false};
+    }
+
+    while (depth > 0) {
+        avl_tree_build_range_t range = stack[--depth];
+        avl_size_t left_count = range.count / 2;
+        avl_size_t right_count = range.count - left_count - 1;
+        avl_node_t *node = &nodes[range.first + left_count];
+        // The left half is never smaller than the right one, so it defines the height.
+        avl_height_t right_height = 0;
+        if (right_count > 0) {
+            right_height = (right_count >= ((avl_size_t)1 << (range.height - 2U)))
+                               ? (avl_height_t)(range.height - 1U)
+                               : (avl_height_t)(range.height - 2U);
+        }
+
+        TEST_ASSERT((0 == left_count) || (AVL_CMP_LT == avl_node_cmp(node - 1, node)));
+        TEST_ASSERT((0 == right_count) || (AVL_CMP_LT == avl_node_cmp(node, node + 1)));
+        avl_node_set_left(node, NULL);
+        avl_node_set_right(node, NULL);
+        avl_node_set_parent(node, range.parent);
+#ifdef AVL_TREE_NODE_BALANCE_FACTOR
+        avl_node_set_balance_factor(node, (int32_t)right_height - (int32_t)(range.height - 1U));
+#else
+        node->height = range.height;
+#endif
+#ifdef AVL_TREE_ORDER_STATISTICS
+        node->size = range.count;
+#endif
+        if (NULL == range.parent) {
+            root_node = node;
+        } else if (range.is_right) {
+            avl_node_set_right(range.parent, node);
+        } else {
+            avl_node_set_left(range.parent, node);
+        }
+
+        if (right_count > 0) {
+            TEST_ASSERT(depth < AVL_TREE_BUILD_STACK_SIZE);
+            stack[depth++] = (avl_tree_build_range_t){.parent = node,
+                                                      .first = range.first + left_count + 1,
+                                                      .count = right_count,
+                                                      .height = right_height,
+                                                      .is_right = true};
+        }
+        if (left_count > 0) {
+            TEST_ASSERT(depth < AVL_TREE_BUILD_STACK_SIZE);
+            stack[depth++] = (avl_tree_build_range_t){.parent = node,
+                                                      .first = range.first,
+                                                      .count = left_count,
+                                                      .height = (avl_height_t)(range.height - 1U),
+                                                      .is_right = false};
+        }
+    }
+    return root_node;
+}
+
+/**
+ * @brief Build AVL-Tree from a sorted node array, replacing its content, not with key offset.
+ *
+ * Not declared with AVL_TREE_NODE_KEY_OFFSET, see avl_tree_build_sorted().
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param nodes Array of nodes @ref avl_node_t sorted by ascending key, no duplicates.
+ * @param count Number of nodes in the array.
+ */
+static inline void avl_tree_build(avl_tree_t *tree, avl_node_t *nodes, avl_size_t count) {
+    tree->root = avl_tree_build_sorted(nodes, count);
+    tree->count = count;
+    avl_tree_cache_refresh(tree);
+}
+#endif // AVL_TREE_NODE_KEY_OFFSET
+
+/**
+ * @brief Read-only snapshot of an AVL-Tree in Eytzinger (BFS) order.
+ *
+ * keys[1] is the root of an implicit complete tree whose children of keys[i] are keys[2i] and
+ * keys[2i + 1], keys[0] is unused. The caller provides both arrays with capacity + 1 entries.
+ */
+typedef struct {
+    avl_key_t *keys;    ///< keys in Eytzinger order, count + 1 entries used
+    avl_node_t **nodes; ///< node of keys[i] at nodes[i], may be NULL if only keys are needed
+    avl_size_t count;   ///< number of keys in the snapshot
+} avl_tree_eytzinger_t;
+
+/**
+ * @brief Count nodes of AVL-Tree by an in-order walk in O(n).
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @return Number of nodes.
+ */
+static inline avl_size_t avl_tree_node_count(avl_node_t *root_node) {
+    avl_node_path_t path;
+    avl_size_t count = 0;
+    path.depth = 0U;
+    avl_node_path_push_left(&path, root_node);
+    while (path.depth > 0U) {
+        avl_node_t *node = path.nodes[--path.depth];
+        count++;
+        avl_node_path_push_left(&path, avl_node_right(node));
+    }
+    return count;
+}
+
+/**
+ * @brief Export AVL-Tree into a snapshot in Eytzinger order.
+ *
+ * After counting the nodes, an in-order walk in O(n) stores each key at the in-order position of
+ * the implicit complete tree. The tree stays untouched and may be changed
+ * afterwards, the snapshot does not follow.
+ *
+ * @param snapshot Snapshot @ref avl_tree_eytzinger_t with keys (and nodes) arrays set.
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param capacity Number of keys the arrays hold besides the unused entry 0.
+ * @return Number of nodes of the tree, nothing is written if it exceeds capacity.
+ */
+static inline avl_size_t avl_tree_eytzinger_export(avl_tree_eytzinger_t *snapshot,
+                                                   avl_node_t *root_node, avl_size_t capacity) {
+    avl_node_path_t path;
+    avl_size_t count = avl_tree_node_count(root_node);
+    path.depth = 0U;
+    if (count <= capacity) {
+        avl_size_t index = 1U;
+        while ((2U * index) <= count) {
+            index *= 2U;
+        }
+        avl_node_path_push_left(&path, root_node);
+        while (path.depth > 0U) {
+            avl_node_t *node = path.nodes[--path.depth];
+            snapshot->keys[index] = avl_node_key(node);
+            if (NULL != snapshot->nodes) {
+                snapshot->nodes[index] = node;
+            }
+            // In-order successor in the implicit tree: leftmost of the right subtree, or the
+            // first ancestor reached from a left child.
+            if ((2U * index + 1U) <= count) {
+                index = 2U * index + 1U;
+                while ((2U * index) <= count) {
+                    index *= 2U;
+                }
+            } else {
+                while (0U != (index & 1U)) {
+                    index >>= 1U;
+                }
+                index >>= 1U;
+            }
+            avl_node_path_push_left(&path, avl_node_right(node));
+        }
+        snapshot->count = count;
+    }
+    return count;
+}
+
+/**
+ * @brief Find key in an Eytzinger snapshot.
+ *
+ * The descent selects the child by arithmetic on the comparison, so the loop has no data
+ * dependent branch and always runs for the full height. Keys four levels ahead are prefetched,
+ * they share one or two cache lines. Keys are compared as integers, with an external
+ * avl_node_key_cmp() or avl_node_cmp() the snapshot only fits a comparator ordering by key.
+ *
+ * @param snapshot Snapshot @ref avl_tree_eytzinger_t.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Index of key in keys (and nodes) or 0 if key is not in the snapshot.
+ */
+static inline avl_size_t avl_tree_eytzinger_search(const avl_tree_eytzinger_t *snapshot,
+                                                   avl_key_t key) {
+    const avl_key_t *keys = snapshot->keys;
+    avl_size_t count = snapshot->count;
+    size_t index = 1U;
+    while (index <= count) {
+        size_t ahead = 16U * index;
+        AVL_TREE_PREFETCH(&keys[(ahead <= count) ? ahead : index]);
+        index = 2U * index + (size_t)(keys[index] < key);
+    }
+    // Undo the right turns taken after the last left turn, which was at the lower bound.
+#ifdef __GNUC__
+    index >>= (unsigned)__builtin_ctzll(~(unsigned long long)index) + 1U;
+#else
+    while (0U != (index & 1U)) {
+        index >>= 1U;
+    }
+    index >>= 1U;
+#endif
+    return ((0U != index) && (keys[index] == key)) ? (avl_size_t)index : 0U;
+}
+
+/** @brief Keys per block of the fat-leaf snapshot, two AVX2 compares for 64-bit keys. */
+#define AVL_TREE_FAT_LEAF_KEYS 8U
+
+/** @brief Upper bound of fat-leaf snapshot levels, 8-way fan-out over up to 2^32 keys. */
+#define AVL_TREE_FAT_LEAF_MAX_LEVELS 12U
+
+/**
+ * @brief Read-only snapshot of an AVL-Tree as sorted key blocks under a shallow index.
+ *
+ * The leaf level is the sorted key array, keys[0] to keys[count - 1]. Each index level above holds
+ * the greatest key of every block of the level below, until a single block remains. Every level
+ * is padded to whole blocks of AVL_TREE_FAT_LEAF_KEYS with the greatest key value.
+ */
+typedef struct {
+    avl_key_t *keys;    ///< blocks of all levels, leaves first, see avl_tree_fat_leaf_capacity()
+    avl_node_t **nodes; ///< node of the leaf key at the same position, may be NULL
+    avl_size_t count;   ///< number of keys in the snapshot
+    avl_size_t levels;  ///< number of levels including the leaves, 0 if empty
+    size_t level_first[AVL_TREE_FAT_LEAF_MAX_LEVELS]; ///< offset of the first key of each level
+} avl_tree_fat_leaf_t;
+
+/**
+ * @brief Size of the keys array a fat-leaf snapshot of count keys needs.
+ *
+ * @param count Number of keys.
+ * @return Number of @ref avl_key_t entries of all padded levels.
+ */
+static inline size_t avl_tree_fat_leaf_capacity(avl_size_t count) {
+    size_t capacity = 0;
+    size_t entries = count;
+    while (entries > 0U) {
+        size_t blocks = (entries + AVL_TREE_FAT_LEAF_KEYS - 1U) / AVL_TREE_FAT_LEAF_KEYS;
+        capacity += blocks * AVL_TREE_FAT_LEAF_KEYS;
+        entries = (blocks > 1U) ? blocks : 0U;
+    }
+    return capacity;
+}
+
+/**
+ * @brief Export AVL-Tree into a fat-leaf snapshot.
+ *
+ * @param snapshot Snapshot @ref avl_tree_fat_leaf_t with keys (and nodes) arrays set, nodes
+ *                 needs one entry per node.
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param capacity Number of keys the keys array holds.
+ * @return Number of nodes of the tree, nothing is written if the snapshot exceeds capacity.
+ */
+static inline avl_size_t avl_tree_fat_leaf_export(avl_tree_fat_leaf_t *snapshot,
+                                                  avl_node_t *root_node, size_t capacity) {
+    avl_size_t count = avl_tree_node_count(root_node);
+    if (avl_tree_fat_leaf_capacity(count) <= capacity) {
+        avl_key_t *keys = snapshot->keys;
+        avl_node_path_t path;
+        size_t entries = 0;
+        size_t first = 0;
+        avl_size_t levels = 0;
+        path.depth = 0U;
+        avl_node_path_push_left(&path, root_node);
+        while (path.depth > 0U) {
+            avl_node_t *node = path.nodes[--path.depth];
+            keys[entries] = avl_node_key(node);
+            if (NULL != snapshot->nodes) {
+                snapshot->nodes[entries] = node;
+            }
+            entries++;
+            avl_node_path_push_left(&path, avl_node_right(node));
+        }
+
+        while (entries > 0U) {
+            size_t blocks = (entries + AVL_TREE_FAT_LEAF_KEYS - 1U) / AVL_TREE_FAT_LEAF_KEYS;
+            size_t next = first + (blocks * AVL_TREE_FAT_LEAF_KEYS);
+            // Padding is never smaller than a key searched for, it does not add to a rank.
+            for (size_t i = first + entries; i < next; i++) {
+                keys[i] = (avl_key_t)~(avl_key_t)0;
+            }
+            TEST_ASSERT(levels < AVL_TREE_FAT_LEAF_MAX_LEVELS);
+            snapshot->level_first[levels++] = first;
+            if (blocks > 1U) {
+                for (size_t block = 0; block < blocks; block++) {
+                    size_t last = (block + 1U) * AVL_TREE_FAT_LEAF_KEYS;
+                    last = (last < entries) ? last : entries;
+                    keys[next + block] = keys[first + last - 1U];
+                }
+                entries = blocks;
+            } else {
+                entries = 0U;
+            }
+            first = next;
+        }
+        snapshot->count = count;
+        snapshot->levels = levels;
+    }
+    return count;
+}
+
+/**
+ * @brief Number of keys smaller than key in a sorted block of AVL_TREE_FAT_LEAF_KEYS keys.
+ *
+ * With AVX2 or SSE4.2 enabled by the compiler the block is compared in vector registers. There
+ * are only signed compares, flipping the sign bit maps the unsigned key order onto them.
+ */
+static inline uint32_t avl_tree_fat_leaf_rank(const avl_key_t *block, avl_key_t key) {
+#if defined(AVL_TREE_FAT_LEAF_AVX2) && (AVL_TREE_KEY_BITS == 64)
+    const __m256i bias = _mm256_set1_epi64x(INT64_MIN);
+    __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x((long long)key), bias);
+    __m256i lo = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)block), bias);
+    __m256i hi = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(block + 4)), bias);
+    uint32_t mask =
+        (uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, lo))) |
+        ((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, hi))) << 4U);
+#elif defined(AVL_TREE_FAT_LEAF_AVX2)
+    const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+    __m256i needle = _mm256_xor_si256(_mm256_set1_epi32((int)key), bias);
+    __m256i all = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)block), bias);
+    uint32_t mask =
+        (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, all)));
+#elif defined(AVL_TREE_FAT_LEAF_SSE42) && (AVL_TREE_KEY_BITS == 64)
+    const __m128i bias = _mm_set1_epi64x(INT64_MIN);
+    __m128i needle = _mm_xor_si128(_mm_set1_epi64x((long long)key), bias);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < AVL_TREE_FAT_LEAF_KEYS; i += 2U) {
+        __m128i pair = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(block + i)), bias);
+        mask |= (uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(needle, pair))) << i;
+    }
+#elif defined(AVL_TREE_FAT_LEAF_SSE42)
+    const __m128i bias = _mm_set1_epi32(INT32_MIN);
+    __m128i needle = _mm_xor_si128(_mm_set1_epi32((int)key), bias);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < AVL_TREE_FAT_LEAF_KEYS; i += 4U) {
+        __m128i quad = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(block + i)), bias);
+        mask |= (uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, quad))) << i;
+    }
+#endif
+#if defined(AVL_TREE_FAT_LEAF_AVX2) || defined(AVL_TREE_FAT_LEAF_SSE42)
+    // The smaller keys of a sorted block form a prefix, the mask is a run of low bits.
+    return (uint32_t)__builtin_ctz(~mask);
+#else
+    uint32_t rank = 0;
+    for (uint32_t i = 0; i < AVL_TREE_FAT_LEAF_KEYS; i++) {
+        rank += (uint32_t)(block[i] < key);
+    }
+    return rank;
+#endif
+}
+
+/**
+ * @brief Position of the first key not smaller than key in a fat-leaf snapshot.
+ *
+ * One block per level is searched, the rank in a block selects the block on the level below.
+ * A range is read from keys (and nodes) starting at the lower bound of its first key. Keys are
+ * compared as integers, like in avl_tree_eytzinger_search().
+ *
+ * @param snapshot Snapshot @ref avl_tree_fat_leaf_t.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Position in the leaf keys, count if all keys are smaller.
+ */
+static inline avl_size_t avl_tree_fat_leaf_lower_bound(const avl_tree_fat_leaf_t *snapshot,
+                                                       avl_key_t key) {
+    const avl_key_t *keys = snapshot->keys;
+    avl_size_t position = snapshot->count;
+    // Beyond the greatest key the padding would match, so every rank below stays in range.
+    if ((position > 0U) && (key <= keys[position - 1U])) {
+        size_t block = 0;
+        for (avl_size_t level = snapshot->levels; level > 0U; level--) {
+            const avl_key_t *first = &keys[snapshot->level_first[level - 1U]];
+            block = (block * AVL_TREE_FAT_LEAF_KEYS) +
+                    avl_tree_fat_leaf_rank(&first[block * AVL_TREE_FAT_LEAF_KEYS], key);
+        }
+        position = (avl_size_t)block;
+    }
+    return position;
+}
+
+/**
+ * @brief Find key in a fat-leaf snapshot.
+ *
+ * @param snapshot Snapshot @ref avl_tree_fat_leaf_t.
+ * @param key Key to search for @ref avl_key_t.
+ * @return Position of key in the leaf keys (and nodes), count if key is not in the snapshot.
+ */
+static inline avl_size_t avl_tree_fat_leaf_search(const avl_tree_fat_leaf_t *snapshot,
+                                                  avl_key_t key) {
+    avl_size_t position = avl_tree_fat_leaf_lower_bound(snapshot, key);
+    return ((position < snapshot->count) && (snapshot->keys[position] == key)) ? position
+                                                                              : snapshot->count;
+}
+
+#ifdef AVL_TREE_ORDER_STATISTICS
+/**
+ * @brief Count nodes smaller than (or equal to) a search key.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param search_key Search key passed to cmp, to count up to.
+ * @param cmp Comparison @ref avl_node_search_cmp_t ordering like avl_node_cmp().
+ * @param inclusive Count the node matching search_key itself as well.
+ * @return Number of nodes.
+ */
+static inline avl_size_t avl_tree_node_count_below_by(avl_node_t *root_node,
+                                                      const void *search_key,
+                                                      avl_node_search_cmp_t cmp, bool inclusive) {
+    avl_size_t count = 0;
+    avl_node_t *current = root_node;
+    while (NULL != current) {
+        switch (cmp(search_key, current)) {
+        case AVL_CMP_LT:
+            current = avl_node_left(current);
+            break;
+        case AVL_CMP_GT:
+            count += avl_node_size(avl_node_left(current)) + 1;
+            current = avl_node_right(current);
+            break;
+        case AVL_CMP_EQ:
+            count += avl_node_size(avl_node_left(current)) + (inclusive ? 1 : 0);
+            current = NULL;
+            break;
+        default:
+            TEST_ASSERT(false); // must never happen
+            break;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Count nodes with key smaller than (or equal to) key.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key to count up to @ref avl_key_t.
+ * @param inclusive Count the node with key itself as well.
+ * @return Number of nodes.
+ */
+static inline avl_size_t avl_tree_node_count_below(avl_node_t *root_node, avl_key_t key,
+                                                   bool inclusive) {
+    return avl_tree_node_count_below_by(root_node, &key, avl_node_search_key_cmp, inclusive);
+}
+
+/**
+ * @brief Rank of key in AVL-Tree.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param key Key @ref avl_key_t, does not need to be in the tree.
+ * @return Number of nodes with a key smaller than key.
+ */
+static inline avl_size_t avl_tree_node_rank(avl_node_t *root_node, avl_key_t key) {
+    return avl_tree_node_count_below(root_node, key, false);
+}
+
+/**
+ * @brief Select node by its in-order position.
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param index Zero based position of node in key order.
+ * @return Node with index-th smallest key or NULL if index is out of range.
+ */
+static inline avl_node_t *avl_tree_node_select(avl_node_t *root_node, avl_size_t index) {
+    avl_node_t *current = root_node;
+    avl_node_t *node_found = NULL;
+    avl_size_t remaining = index;
+    while ((NULL == node_found) && (NULL != current)) {
+        avl_size_t left_size = avl_node_size(avl_node_left(current));
+        if (remaining < left_size) {
+            current = avl_node_left(current);
+        } else if (remaining == left_size) {
+            node_found = current;
+        } else {
+            remaining -= left_size + 1;
+            current = avl_node_right(current);
+        }
+    }
+    return node_found;
+}
+
+/**
+ * @brief Count nodes with key in closed range [lo, hi].
+ *
+ * @param root_node Root node @ref avl_node_t of AVL-Tree.
+ * @param lo Lower bound of range @ref avl_key_t.
+ * @param hi Upper bound of range @ref avl_key_t.
+ * @return Number of nodes in range, 0 if lo is greater than hi.
+ */
+static inline avl_size_t avl_tree_node_count_range(avl_node_t *root_node, avl_key_t lo,
+                                                   avl_key_t hi) {
+    // With lo greater than hi fewer nodes are up to hi than below lo, no key comparison needed.
+    avl_size_t up_to_hi = avl_tree_node_count_below(root_node, hi, true);
+    avl_size_t below_lo = avl_tree_node_count_below(root_node, lo, false);
+    return (up_to_hi > below_lo) ? (up_to_hi - below_lo) : 0U;
+}
+#endif
+
 #endif // AVL_TREE_H
@@ -0,0 +1,274 @@
+#ifndef AVL_TREE_DEFINE_H
+#define AVL_TREE_DEFINE_H
+
+/**
+ * @brief Generator of typed AVL Trees for a node type, key type and comparator.
+ * @copyright Anton Ivanov, MIT License 2025
+ *
+ * avl_tree.h orders its nodes by the single avl_node_cmp() of a translation unit. Its key
+ * dependent functions have *_by() variants taking the comparison as @ref avl_node_search_cmp_t,
+ * AVL_TREE_DEFINE() wraps them for one node type, so any number of differently keyed trees
+ * coexist. The comparisons are constants, each one inlines into the descents:
+ *
+ * @code
+ * typedef struct route {
+ *     avl_node_t node;
+ *     route_key_t key;
+ *     uint32_t next_hop;
+ * } route_t;
+ *
+ * static inline int route_key_cmp(const route_key_t *a, const route_key_t *b) { ... }
+ *
+ * AVL_TREE_DEFINE(route_tree, route_t, node, route_key_t, key, route_key_cmp)
+ * @endcode
+ *
+ * The node type embeds an @ref avl_node_t, all rebalancing is done by avl_tree.h in the layout
+ * selected by its options. The embedded node holds links only: unless given, this header selects
+ * AVL_TREE_NODE_KEY_OFFSET, so it has to come before avl_tree.h, and the key lives in key_member.
+ * avl_node_t trees of avl_tree.h in the same translation unit then embed their nodes in a
+ * container with the avl_key_t right before the node, see avl_node_key().
+ *
+ * cmp(const key_type *a, const key_type *b) returns a negative value, 0 or a positive value, it
+ * may be a function or a macro. Keys are passed by pointer and never copied. Roots are plain
+ * avl_node_t pointers or an @ref avl_tree_t, as in avl_tree.h.
+ *
+ * Generated functions, with the semantics of their avl_tree.h counterparts:
+ * - prefix_of(): node_type of an avl_node_t, NULL for NULL
+ * - prefix_lookup(), prefix_lower_bound(), prefix_upper_bound(), prefix_floor(),
+ *   prefix_ceiling(), prefix_first(), prefix_last(), prefix_next(), prefix_prev()
+ * - prefix_range_begin(), prefix_range_next() with prefix_range_t, hi is kept by pointer
+ * - prefix_insert_or_get(), prefix_insert(), prefix_remove_node_ptr(), prefix_remove_node()
+ * - prefix_split(), prefix_join()
+ * - prefix_tree_insert(), prefix_tree_remove(), prefix_tree_remove_key(), prefix_tree_peek_min(),
+ *   prefix_tree_peek_max(), prefix_tree_pop_min(), prefix_tree_pop_max(), prefix_tree_union(),
+ *   prefix_tree_intersection(), prefix_tree_difference()
+ * - with AVL_TREE_ORDER_STATISTICS: prefix_rank(), prefix_select(), prefix_count_range()
+ *
+ * Functions without keys apply to generated trees as they are: avl_tree_count(),
+ * avl_tree_join2(), avl_tree_node_count(). Not generated, as they are bound to @ref avl_key_t or
+ * to arrays of avl_node_t: avl_tree_build_sorted() and avl_tree_build(),
+ * avl_tree_node_lookup_batch(), avl_tree_node_lookup_sorted(), the Eytzinger and fat-leaf
+ * snapshots.
+ *
+ * Not available with AVL_TREE_NODE_INDEX_LINKS, whose nodes all live in AVL_TREE_NODE_POOL.
+ */
+
+#include <stddef.h>
+
+#ifndef AVL_TREE_NODE_KEY_OFFSET
+#ifdef AVL_TREE_H
+#error "Include avl_tree_define.h before avl_tree.h, it selects the links-only avl_node_t"
+#endif
+/** @brief Links-only nodes, the avl_key_t of avl_tree.h trees is right before the node. */
+#define AVL_TREE_NODE_KEY_OFFSET (-(ptrdiff_t)sizeof(avl_key_t))
+#endif
+
+#include "avl_tree.h"
+
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+#error "AVL_TREE_DEFINE() embeds nodes into node types, not with AVL_TREE_NODE_INDEX_LINKS"
+#endif
+
+#ifdef AVL_TREE_ORDER_STATISTICS
+/** @brief Order statistics functions of AVL_TREE_DEFINE(), see there. */
+#define AVL_TREE_DEFINE_ORDER_STATISTICS(prefix, node_type, key_type)                              \
+    static inline avl_size_t prefix##_rank(avl_node_t *root_node, const key_type *key) {           \
+        return avl_tree_node_count_below_by(root_node, key, prefix##_key_cmp, false);              \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_select(avl_node_t *root_node, avl_size_t index) {            \
+        return prefix##_of(avl_tree_node_select(root_node, index));                                \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_size_t prefix##_count_range(avl_node_t *root_node, const key_type *lo,       \
+                                                  const key_type *hi) {                            \
+        avl_size_t up_to_hi = avl_tree_node_count_below_by(root_node, hi, prefix##_key_cmp, true); \
+        avl_size_t below_lo = avl_tree_node_count_below_by(root_node, lo, prefix##_key_cmp, false);\
+        return (up_to_hi > below_lo) ? (up_to_hi - below_lo) : 0U;                                 \
+    }
+#else
+#define AVL_TREE_DEFINE_ORDER_STATISTICS(prefix, node_type, key_type)
+#endif
+
+/**
+ * @brief Define the functions of an AVL Tree named prefix.
+ *
+ * @param prefix Prefix of all generated functions.
+ * @param node_type Node type embedding an @ref avl_node_t.
+ * @param node_member Name of the @ref avl_node_t member of node_type.
+ * @param key_type Type of the key member.
+ * @param key_member Name of the key member of node_type.
+ * @param cmp Comparator cmp(const key_type *, const key_type *) returning <0, 0 or >0.
+ */
+#define AVL_TREE_DEFINE(prefix, node_type, node_member, key_type, key_member, cmp)                 \
+    static inline node_type *prefix##_of(avl_node_t *node) {                                       \
+        return (NULL == node) ? NULL : AVL_CONTAINER_OF(node, node_type, node_member);             \
+    }                                                                                              \
+                                                                                                   \
+    /* Search key comparison of avl_tree.h, the search key is a key_type. */                       \
+    static inline avl_node_cmp_result_t prefix##_key_cmp(const void *search_key,                   \
+                                                         const avl_node_t *node) {                 \
+        const node_type *other = AVL_CONTAINER_OF(node, node_type, node_member);                   \
+        int result = cmp((const key_type *)search_key, &other->key_member);                        \
+        return (result < 0) ? AVL_CMP_LT : ((result > 0) ? AVL_CMP_GT : AVL_CMP_EQ);               \
+    }                                                                                              \
+                                                                                                   \
+    /* Search key comparison of avl_tree.h, the search key is a node. */                           \
+    static inline avl_node_cmp_result_t prefix##_node_cmp(const void *search_node,                 \
+                                                          const avl_node_t *node) {                \
+        const node_type *searched = AVL_CONTAINER_OF(search_node, node_type, node_member);         \
+        return prefix##_key_cmp(&searched->key_member, node);                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_lookup(avl_node_t *root_node, const key_type *key) {         \
+        return prefix##_of(avl_tree_node_find(root_node, key, prefix##_key_cmp));                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_lower_bound(avl_node_t *root_node, const key_type *key) {    \
+        return prefix##_of(avl_tree_node_bound_by(root_node, key, prefix##_key_cmp, true, true));  \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_upper_bound(avl_node_t *root_node, const key_type *key) {    \
+        return prefix##_of(avl_tree_node_bound_by(root_node, key, prefix##_key_cmp, true, false)); \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_floor(avl_node_t *root_node, const key_type *key) {          \
+        return prefix##_of(avl_tree_node_bound_by(root_node, key, prefix##_key_cmp, false, true)); \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_ceiling(avl_node_t *root_node, const key_type *key) {        \
+        return prefix##_lower_bound(root_node, key);                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_first(avl_node_t *root_node) {                               \
+        return prefix##_of(avl_tree_first(root_node));                                             \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_last(avl_node_t *root_node) {                                \
+        return prefix##_of(avl_tree_last(root_node));                                              \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_next(avl_node_t *root_node, node_type *node) {               \
+        return prefix##_of(avl_tree_node_step_by(root_node, &node->node_member, prefix##_node_cmp, \
+                                                 AVL_DIR_RIGHT));                                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_prev(avl_node_t *root_node, node_type *node) {               \
+        return prefix##_of(avl_tree_node_step_by(root_node, &node->node_member, prefix##_node_cmp, \
+                                                 AVL_DIR_LEFT));                                   \
+    }                                                                                              \
+                                                                                                   \
+    /* Iterator over nodes with keys in a closed range, hi must outlive it. */                     \
+    typedef struct {                                                                               \
+        avl_node_walk_t walk;                                                                      \
+        const key_type *hi;                                                                        \
+    } prefix##_range_t;                                                                            \
+                                                                                                   \
+    static inline void prefix##_range_begin(prefix##_range_t *range, avl_node_t *root_node,        \
+                                            const key_type *lo, const key_type *hi) {              \
+        avl_node_walk_begin(&range->walk, root_node, lo, prefix##_key_cmp);                        \
+        range->hi = hi;                                                                            \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_range_next(prefix##_range_t *range) {                        \
+        return prefix##_of(avl_node_walk_next(&range->walk, range->hi, prefix##_key_cmp));         \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_node_t *prefix##_insert_or_get(avl_node_t *root_node, node_type *new_node,   \
+                                                     node_type **node_out) {                       \
+        avl_node_t *node = NULL;                                                                   \
+        avl_node_t *new_root_node = avl_tree_node_insert_or_get_by(                                \
+            root_node, &new_node->node_member, prefix##_node_cmp, &node);                          \
+        *node_out = prefix##_of(node);                                                             \
+        return new_root_node;                                                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_node_t *prefix##_insert(avl_node_t *root_node, node_type *new_node) {        \
+        node_type *node = NULL;                                                                    \
+        avl_node_t *new_root_node = prefix##_insert_or_get(root_node, new_node, &node);            \
+        TEST_ASSERT(node == new_node); /* key already exists */                                    \
+        return new_root_node;                                                                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_node_t *prefix##_remove_node_ptr(avl_node_t *root_node,                      \
+                                                       node_type *node_to_remove) {                \
+        return avl_tree_remove_node_ptr_by(                                                        \
+            root_node, (NULL == node_to_remove) ? NULL : &node_to_remove->node_member,             \
+            prefix##_node_cmp);                                                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_node_t *prefix##_remove_node(avl_node_t *root_node, const key_type *key) {   \
+        return prefix##_remove_node_ptr(root_node, prefix##_lookup(root_node, key));               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_split(avl_node_t *root_node, const key_type *key,            \
+                                            avl_node_t **left, avl_node_t **right) {               \
+        int32_t left_height = 0;                                                                   \
+        int32_t right_height = 0;                                                                  \
+        return prefix##_of(avl_node_split_by(root_node, key, prefix##_key_cmp, left,               \
+                                             &left_height, right, &right_height));                 \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_node_t *prefix##_join(avl_node_t *left, node_type *pivot,                    \
+                                            avl_node_t *right) {                                   \
+        return avl_tree_join(left, &pivot->node_member, right);                                    \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_insert(avl_tree_t *tree, node_type *new_node) {         \
+        return prefix##_of(avl_tree_insert_by(tree, &new_node->node_member, prefix##_node_cmp));   \
+    }                                                                                              \
+                                                                                                   \
+    static inline void prefix##_tree_remove(avl_tree_t *tree, node_type *node) {                   \
+        avl_tree_remove_by(tree, &node->node_member, prefix##_node_cmp);                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_remove_key(avl_tree_t *tree, const key_type *key) {     \
+        node_type *node = prefix##_lookup(tree->root, key);                                        \
+        if (NULL != node) {                                                                        \
+            prefix##_tree_remove(tree, node);                                                      \
+        }                                                                                          \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_peek_min(avl_tree_t *tree) {                            \
+        return prefix##_of(avl_tree_peek_min(tree));                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_peek_max(avl_tree_t *tree) {                            \
+        return prefix##_of(avl_tree_peek_max(tree));                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_pop_min(avl_tree_t *tree) {                             \
+        node_type *node = prefix##_tree_peek_min(tree);                                            \
+        if (NULL != node) {                                                                        \
+            prefix##_tree_remove(tree, node);                                                      \
+        }                                                                                          \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline node_type *prefix##_tree_pop_max(avl_tree_t *tree) {                             \
+        node_type *node = prefix##_tree_peek_max(tree);                                            \
+        if (NULL != node) {                                                                        \
+            prefix##_tree_remove(tree, node);                                                      \
+        }                                                                                          \
+        return node;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_size_t prefix##_tree_union(avl_tree_t *tree, avl_tree_t *other,              \
+                                                 avl_tree_t *duplicates) {                         \
+        return avl_tree_union_by(tree, other, duplicates, prefix##_node_cmp);                      \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_size_t prefix##_tree_intersection(avl_tree_t *tree, const avl_tree_t *other, \
+                                                        avl_tree_t *removed) {                     \
+        return avl_tree_intersection_by(tree, other, removed, prefix##_node_cmp);                  \
+    }                                                                                              \
+                                                                                                   \
+    static inline avl_size_t prefix##_tree_difference(avl_tree_t *tree, const avl_tree_t *other,   \
+                                                      avl_tree_t *removed) {                       \
+        return avl_tree_difference_by(tree, other, removed, prefix##_node_cmp);                    \
+    }                                                                                              \
+                                                                                                   \
+    AVL_TREE_DEFINE_ORDER_STATISTICS(prefix, node_type, key_type)
+
+#endif // AVL_TREE_DEFINE_H
@@ -0,0 +1,237 @@
+#ifndef AVL_TREE_POOL_H
+#define AVL_TREE_POOL_H
+
+/**
+ * @brief Fixed-capacity node pool for AVL Tree, O(1) allocation and release, no heap.
+ * @copyright Anton Ivanov, MIT License 2025
+ *
+ * The user provides the node storage, typically a static array, and a free map of
+ * AVL_NODE_POOL_MAP_WORDS(capacity) words. Nodes never used so far are handed out in array order.
+ * Released nodes are chained into a free list through their left (next) and right (previous)
+ * links and marked in the free map, one bit per node.
+ *
+ * The storage is split into regions of AVL_NODE_POOL_REGION_NODES nodes, one free map word each.
+ * avl_node_pool_alloc_near() takes a hint, typically the future parent, and returns the released
+ * node closest to it in the hint's region, so parents and children share cache lines and pages
+ * after churn as well. Without a hint or without a released node in the region, the most recently
+ * released node is reused while it is still in the cache, then untouched storage.
+ * avl_tree_pool_insert() passes the parent of the new node as the hint.
+ *
+ * With AVL_TREE_NODE_INDEX_LINKS the storage has to be AVL_TREE_NODE_POOL, the free list is linked
+ * by index like the tree.
+ */
+
+#include "avl_tree.h"
+
+#ifndef AVL_TREE_POOL_EXHAUSTED_HOOK
+/**
+ * @brief Hook called with the pool when an allocation fails because all nodes are in use.
+ *
+ * Define it before including this header to report exhaustion, e.g. to log or to trap in a
+ * safety-critical build. Does nothing by default, the allocation returns NULL.
+ */
+#define AVL_TREE_POOL_EXHAUSTED_HOOK(pool) ((void)(pool))
+#endif
+
+/** @brief Nodes per region of the storage, the bits of a free map word. */
+#define AVL_NODE_POOL_REGION_NODES 64U
+
+/** @brief Number of free map words for a pool of capacity nodes. */
+#define AVL_NODE_POOL_MAP_WORDS(capacity)                                                          \
+    (((capacity) + AVL_NODE_POOL_REGION_NODES - 1U) / AVL_NODE_POOL_REGION_NODES)
+
+/** @brief Fixed-capacity node pool. */
+typedef struct {
+    avl_node_t *nodes;     ///< storage of capacity nodes, provided by the user
+    uint64_t *free_map;    ///< bit per node set while released, provided by the user
+    avl_node_t *free_list; ///< released nodes, most recent first, NULL if empty
+    avl_size_t capacity;   ///< number of nodes in storage
+    avl_size_t high_water; ///< nodes taken from storage so far, the peak number in use
+    avl_size_t used;       ///< nodes currently allocated
+    avl_size_t exhausted;  ///< number of failed allocations
+} avl_node_pool_t;
+
+/**
+ * @brief Initialize pool over node storage, all nodes are free.
+ *
+ * @param pool Pool @ref avl_node_pool_t.
+ * @param nodes Node storage @ref avl_node_t, not touched until handed out.
+ * @param capacity Number of nodes in storage.
+ * @param free_map Free map of AVL_NODE_POOL_MAP_WORDS(capacity) words, cleared here.
+ */
+static inline void avl_node_pool_init(avl_node_pool_t *pool, avl_node_t *nodes,
+                                      avl_size_t capacity, uint64_t *free_map) {
+#ifdef AVL_TREE_NODE_INDEX_LINKS
+    TEST_ASSERT(nodes == AVL_TREE_NODE_POOL);
+#endif
+    pool->nodes = nodes;
+    pool->free_map = free_map;
+    pool->free_list = NULL;
+    pool->capacity = capacity;
+    pool->high_water = 0;
+    pool->used = 0;
+    pool->exhausted = 0;
+    for (avl_size_t word = 0; word < AVL_NODE_POOL_MAP_WORDS(capacity); word++) {
+        free_map[word] = 0U;
+    }
+}
+
+/**
+ * @brief Take a released node out of the free list and the free map.
+ *
+ * @param pool Pool @ref avl_node_pool_t.
+ * @param node Released node @ref avl_node_t.
+ */
+static inline void avl_node_pool_take(avl_node_pool_t *pool, avl_node_t *node) {
+    avl_size_t index = (avl_size_t)(node - pool->nodes);
+    avl_node_t *next = avl_node_left(node);
+    avl_node_t *prev = avl_node_right(node);
+    if (NULL == prev) {
+        pool->free_list = next;
+    } else {
+        avl_node_set_left(prev, next);
+    }
+    if (NULL != next) {
+        avl_node_set_right(next, prev);
+    }
+    pool->free_map[index / AVL_NODE_POOL_REGION_NODES] &=
+        ~((uint64_t)1U << (index % AVL_NODE_POOL_REGION_NODES));
+}
+
+/**
+ * @brief Allocate a node close to hint in O(1).
+ *
+ * The released node of hint's region closest to hint is taken, the search is bounded by the
+ * region size. Otherwise the allocation is the one of avl_node_pool_alloc().
+ *
+ * @param pool Pool @ref avl_node_pool_t.
+ * @param hint Node @ref avl_node_t of pool to allocate next to, may be NULL.
+ * @return Node @ref avl_node_t with undefined content or NULL if the pool is exhausted.
+ */
+static inline avl_node_t *avl_node_pool_alloc_near(avl_node_pool_t *pool, avl_node_t *hint) {
+    avl_node_t *node = NULL;
+    if (NULL != hint) {
+        TEST_ASSERT((hint >= pool->nodes) && (hint < &pool->nodes[pool->high_water]));
+        avl_size_t index = (avl_size_t)(hint - pool->nodes);
+        avl_size_t bit = index % AVL_NODE_POOL_REGION_NODES;
+        avl_node_t *first = &pool->nodes[index - bit];
+        uint64_t word = pool->free_map[index / AVL_NODE_POOL_REGION_NODES];
+        TEST_ASSERT(0U == ((word >> bit) & 1U)); // hint is in use
+        // Alternate above and below hint, the first released node ends the search.
+        for (avl_size_t distance = 1U;
+             (0U != word) && (NULL == node) && (distance < AVL_NODE_POOL_REGION_NODES);
+             distance++) {
+            if (((bit + distance) < AVL_NODE_POOL_REGION_NODES) &&
+                (0U != ((word >> (bit + distance)) & 1U))) {
+                node = &first[bit + distance];
+            } else if ((bit >= distance) && (0U != ((word >> (bit - distance)) & 1U))) {
+                node = &first[bit - distance];
+            }
+        }
+    }
+    if (NULL != node) {
+        avl_node_pool_take(pool, node);
+    } else if (NULL != pool->free_list) {
+        node = pool->free_list;
+        avl_node_pool_take(pool, node);
+    } else if (pool->high_water < pool->capacity) {
+        node = &pool->nodes[pool->high_water++];
+    } else {
+        pool->exhausted++;
+        AVL_TREE_POOL_EXHAUSTED_HOOK(pool);
+    }
+    if (NULL != node) {
+        pool->used++;
+    }
+    return node;
+}
+
+/**
+ * @brief Allocate a node in O(1), the most recently released one first.
+ *
+ * @param pool Pool @ref avl_node_pool_t.
+ * @return Node @ref avl_node_t with undefined content or NULL if the pool is exhausted.
+ */
+static inline avl_node_t *avl_node_pool_alloc(avl_node_pool_t *pool) {
+    return avl_node_pool_alloc_near(pool, NULL);
+}
+
+/**
+ * @brief Release a node to the pool in O(1).
+ *
+ * @param pool Pool @ref avl_node_pool_t the node was allocated from.
+ * @param node Node @ref avl_node_t not in any tree, may be NULL.
+ */
+static inline void avl_node_pool_free(avl_node_pool_t *pool, avl_node_t *node) {
+    if (NULL != node) {
+        avl_size_t index = (avl_size_t)(node - pool->nodes);
+        TEST_ASSERT((node >= pool->nodes) && (index < pool->high_water));
+        TEST_ASSERT(pool->used > 0U);
+        avl_node_set_left(node, pool->free_list);
+        avl_node_set_right(node, NULL);
+        if (NULL != pool->free_list) {
+            avl_node_set_right(pool->free_list, node);
+        }
+        pool->free_list = node;
+        pool->free_map[index / AVL_NODE_POOL_REGION_NODES] |=
+            (uint64_t)1U << (index % AVL_NODE_POOL_REGION_NODES);
+        pool->used--;
+    }
+}
+
+#ifndef AVL_TREE_NODE_KEY_OFFSET
+/**
+ * @brief Insert key into AVL-Tree with a node from pool.
+ *
+ * The descent looking for key ends at the parent of a new node, the node is allocated next to it
+ * and inserted along the path just read. An existing key takes no node, also with the pool full
+ * and without reporting exhaustion. Not available with AVL_TREE_NODE_KEY_OFFSET, pool nodes have
+ * no container to hold the key.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param pool Pool @ref avl_node_pool_t.
+ * @param key Key to insert @ref avl_key_t.
+ * @return Node with key, NULL if key is new and the pool is exhausted.
+ */
+static inline avl_node_t *avl_tree_pool_insert(avl_tree_t *tree, avl_node_pool_t *pool,
+                                               avl_key_t key) {
+    avl_node_t *node = NULL;
+    avl_node_t *parent = NULL;
+    avl_node_t *current = tree->root;
+    while ((NULL == node) && (NULL != current)) {
+        avl_node_cmp_result_t cmp_result = avl_node_key_cmp(&key, current);
+        if (AVL_CMP_EQ == cmp_result) {
+            node = current;
+        } else {
+            parent = current;
+            current = avl_node_child(current, avl_cmp_dir(cmp_result));
+        }
+    }
+    if (NULL == node) {
+        node = avl_node_pool_alloc_near(pool, parent);
+        if (NULL != node) {
+            node->key = key;
+            avl_node_t *inserted = avl_tree_insert(tree, node);
+            TEST_ASSERT(inserted == node);
+            (void)inserted;
+        }
+    }
+    return node;
+}
+#endif
+
+/**
+ * @brief Remove key from AVL-Tree and release its node to pool.
+ *
+ * @param tree AVL-Tree @ref avl_tree_t.
+ * @param pool Pool @ref avl_node_pool_t the nodes of tree come from.
+ * @param key Key to remove @ref avl_key_t.
+ * @return True if key was found and removed.
+ */
+static inline bool avl_tree_pool_remove(avl_tree_t *tree, avl_node_pool_t *pool, avl_key_t key) {
+    avl_node_t *node = avl_tree_remove_key(tree, key);
+    avl_node_pool_free(pool, node);
+    return NULL != node;
+}
+
+#endif // AVL_TREE_POOL_H
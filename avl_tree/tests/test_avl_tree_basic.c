@@ -4,7 +4,21 @@
 #include <stdlib.h>
 #include <time.h>
 
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t rebalance_levels_total = 0;
+static uint32_t rebalance_levels_max = 0;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+#define AVL_TREE_REBALANCE_LEVELS_HOOK(levels)                                                     \
+    do {                                                                                           \
+        rebalance_levels_total += (levels);                                                        \
+        if ((levels) > rebalance_levels_max) {                                                     \
+            rebalance_levels_max = (levels);                                                       \
+        }                                                                                          \
+    } while (0)
+
 #include "avl_tree.h"
+#include "test_avl_tree_check.h"
 
 #define MAX_NODES 1024
 
@@ -13,60 +27,18 @@ static avl_tree_t avl_tree = {.root = NULL};
 static avl_node_t avl_node_buffer[MAX_NODES];
 // NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
 
-static inline void avl_tree_validate(avl_node_t *node, avl_node_t *parent) {
-#ifdef DEBUG
-    if (NULL != node) {
-        printf("-"); // Validation suffix begin
-        // Parent
-        if (NULL == parent) {
-            assert(NULL == node->parent); // Tree root node has no parent
-            printf("R");
-        } else {
-            assert(NULL != node->parent); // Tree leaves have parent
-            printf("P");
-        }
-        // Left child
-        if (NULL != node->left) {
-            assert(AVL_CMP_GT != avl_node_cmp(node->left, node)); // left child not greater
-            assert(node->left->parent == node);   // left child's parent is this node
-            printf("L");
-        }
-        // Right child
-        if (NULL != node->right) {
-            assert(node->right->key >= node->key); // right child not smaller
-            assert(node->right->parent == node);   // right child's parent is this node
-            printf("R");
-        }
-        // Balance factor within [-1, 1].
-        int32_t balance_factor = avl_node_balance_factor(node);
-        assert((-1 <= balance_factor) && (balance_factor <= 1));
-        printf("B");
-        // Check heights are correct.
-        int left_height = avl_node_height(node->left);
-        int right_height = avl_node_height(node->right);
-        assert(node->height == 1 + (left_height > right_height ? left_height : right_height));
-        printf("H");
-        printf("-valid\n");
-    }
-#else
-    (void)node;
-    (void)parent;
-    printf("\n");
-#endif
-}
-
 // NOLINTBEGIN(misc-no-recursion)
 // Recursion: this is a visual helper to a test code, recursion is OK here
-static inline void avl_tree_node_print(avl_node_t *node, avl_node_t *parent, int level) {
+static inline void avl_tree_node_print(avl_node_t *node, int level) {
     if (NULL != node) {
-        avl_tree_node_print(node->right, node, level + 1);
+        avl_tree_node_print(node->right, level + 1);
         for (int i = 0; i < level; i++) {
             printf("\t");
         }
         printf("%lu[h%u.b%d.p%lu]", node->key, node->height, avl_node_balance_factor(node),
                node->parent ? node->parent->key : 0);
-        avl_tree_validate(node, parent);
-        avl_tree_node_print(node->left, node, level + 1);
+        printf("\n");
+        avl_tree_node_print(node->left, level + 1);
     }
 }
 // NOLINTEND(misc-no-recursion)
@@ -125,12 +97,96 @@ static inline void test_find_all_nodes(void) {
     printf("------------------------\n");
 }
 
+static inline void test_iterate(void) {
+    printf("\n------------------------\n");
+    int count = 0;
+    avl_node_t *prev = NULL;
+    for (avl_node_t *node = avl_tree_first(avl_tree.root); NULL != node;
+         node = avl_node_next(node)) {
+        assert((NULL == prev) || (AVL_CMP_LT == avl_node_cmp(prev, node)));
+        assert(avl_node_prev(node) == prev);
+        prev = node;
+        count++;
+    }
+    assert(count == MAX_NODES);
+    assert(prev == avl_tree_last(avl_tree.root));
+    (void)prev;
+
+    avl_key_t lo = avl_node_buffer[MAX_NODES / 3].key;
+    avl_key_t hi = lo + (avl_key_t)MAX_NODES;
+    int expected = 0;
+    for (int i = 0; i < MAX_NODES; i++) {
+        expected += ((avl_node_buffer[i].key >= lo) && (avl_node_buffer[i].key <= hi)) ? 1 : 0;
+    }
+    avl_tree_range_t range;
+    count = 0;
+    avl_tree_range_begin(&range, avl_tree.root, lo, hi);
+    for (avl_node_t *node = avl_tree_range_next(&range); NULL != node;
+         node = avl_tree_range_next(&range)) {
+        assert((node->key >= lo) && (node->key <= hi));
+        count++;
+    }
+    assert(count == expected);
+    avl_tree_range_begin(&range, avl_tree.root, hi, lo);
+    assert(NULL == avl_tree_range_next(&range));
+    printf("Iterate passed, %d nodes in [%lu, %lu]\n", count, lo, hi);
+    printf("------------------------\n");
+}
+
+static inline void test_bounds(void) {
+    printf("\n------------------------\n");
+    for (avl_key_t key = 0; key <= (avl_key_t)(10 * MAX_NODES) + 1; key += 3) {
+        avl_node_t *lower = NULL;
+        avl_node_t *upper = NULL;
+        avl_node_t *floor = NULL;
+        for (int i = 0; i < MAX_NODES; i++) {
+            avl_node_t *node = &avl_node_buffer[i];
+            if ((node->key >= key) && ((NULL == lower) || (node->key < lower->key))) {
+                lower = node;
+            }
+            if ((node->key > key) && ((NULL == upper) || (node->key < upper->key))) {
+                upper = node;
+            }
+            if ((node->key <= key) && ((NULL == floor) || (node->key > floor->key))) {
+                floor = node;
+            }
+        }
+        assert(avl_tree_node_lower_bound(avl_tree.root, key) == lower);
+        assert(avl_tree_node_ceiling(avl_tree.root, key) == lower);
+        assert(avl_tree_node_upper_bound(avl_tree.root, key) == upper);
+        assert(avl_tree_node_floor(avl_tree.root, key) == floor);
+    }
+    printf("Bounds passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_insert_or_get(void) {
+    printf("\n------------------------\n");
+    avl_node_t extra_node = {.key = (avl_key_t)(10 * MAX_NODES) + 1};
+    for (int i = 0; i < MAX_NODES; i += 17) {
+        avl_node_t duplicate = {.key = avl_node_buffer[i].key};
+        avl_node_t *node = NULL;
+        avl_node_t *root = avl_tree_node_insert_or_get(avl_tree.root, &duplicate, &node);
+        assert((root == avl_tree.root) && (node == &avl_node_buffer[i]));
+        (void)root;
+    }
+    avl_node_t *node = NULL;
+    avl_tree.root = avl_tree_node_insert_or_get(avl_tree.root, &extra_node, &node);
+    assert(node == &extra_node);
+    (void)avl_tree_check(avl_tree.root, NULL);
+    avl_tree.root = avl_tree_remove_node(avl_tree.root, extra_node.key);
+    assert(NULL == avl_tree_node_lookup(avl_tree.root, extra_node.key));
+    printf("Insert or get passed\n");
+    printf("------------------------\n");
+}
+
 static inline void test_insert_nodes_in_order(void) {
     for (int i = 0; i < MAX_NODES; i++) {
         printf("\n------------------------\n");
         printf("Insert node %lu\n", avl_node_buffer[i].key);
         avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
-        avl_tree_node_print(avl_tree.root, NULL, 0);
+        avl_tree_node_print(avl_tree.root, 0);
+        (void)avl_tree_check(avl_tree.root, NULL);
         printf("------------------------\n");
     }
 }
@@ -140,7 +196,8 @@ static inline void test_insert_nodes_in_reverse_order(void) {
         printf("\n------------------------\n");
         printf("Insert node %lu\n", avl_node_buffer[i].key);
         avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
-        avl_tree_node_print(avl_tree.root, NULL, 0);
+        avl_tree_node_print(avl_tree.root, 0);
+        (void)avl_tree_check(avl_tree.root, NULL);
         printf("------------------------\n");
     }
 }
@@ -151,7 +208,8 @@ static inline void test_remove_nodes_in_order(void) {
         printf("Removing node %lu\n", avl_node_buffer[i].key);
         TEST_ASSERT(avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key) != NULL);
         avl_tree.root = avl_tree_remove_node(avl_tree.root, avl_node_buffer[i].key);
-        avl_tree_node_print(avl_tree.root, NULL, 0);
+        avl_tree_node_print(avl_tree.root, 0);
+        (void)avl_tree_check(avl_tree.root, NULL);
         printf("------------------------\n");
     }
 }
@@ -162,11 +220,104 @@ static inline void test_remove_nodes_in_reverse_order(void) {
         printf("Removing node %lu\n", avl_node_buffer[i].key);
         TEST_ASSERT(avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key) != NULL);
         avl_tree.root = avl_tree_remove_node(avl_tree.root, avl_node_buffer[i].key);
-        avl_tree_node_print(avl_tree.root, NULL, 0);
+        avl_tree_node_print(avl_tree.root, 0);
+        (void)avl_tree_check(avl_tree.root, NULL);
         printf("------------------------\n");
     }
 }
 
+static inline void test_rebalance_levels(void) {
+    printf("\n------------------------\n");
+    rebalance_levels_total = 0;
+    rebalance_levels_max = 0;
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
+    }
+    (void)avl_tree_check(avl_tree.root, NULL);
+    printf("Insert: %u levels visited in total, %u at most\n", rebalance_levels_total,
+           rebalance_levels_max);
+    assert(rebalance_levels_total < 4 * MAX_NODES); // amortized O(1) per insert
+
+    rebalance_levels_total = 0;
+    rebalance_levels_max = 0;
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_tree.root = avl_tree_remove_node(avl_tree.root, avl_node_buffer[i].key);
+        if (0 == (i % 64)) {
+            (void)avl_tree_check(avl_tree.root, NULL);
+        }
+    }
+    assert(NULL == avl_tree.root);
+    printf("Remove: %u levels visited in total, %u at most\n", rebalance_levels_total,
+           rebalance_levels_max);
+    assert(rebalance_levels_total < 4 * MAX_NODES); // amortized O(1) per remove
+    printf("------------------------\n");
+}
+
+static inline void test_build_sorted(void) {
+    printf("\n------------------------\n");
+    for (avl_size_t count = 0; count <= 33; count++) {
+        avl_node_t *root = avl_tree_build_sorted(avl_node_buffer, count);
+        (void)avl_tree_check(root, NULL);
+        for (avl_size_t i = 0; i < count; i++) {
+            assert(avl_tree_node_lookup(root, avl_node_buffer[i].key) == &avl_node_buffer[i]);
+        }
+    }
+    avl_tree.root = avl_tree_build_sorted(avl_node_buffer, MAX_NODES);
+    printf("Built tree of height %d\n", avl_tree_check(avl_tree.root, NULL));
+    avl_tree_node_print(avl_tree.root, 0);
+    printf("------------------------\n");
+}
+
+static inline void test_split_join(void) {
+    printf("\n------------------------\n");
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
+    }
+    for (int i = 0; i < MAX_NODES; i += 37) {
+        avl_node_t *left = NULL;
+        avl_node_t *right = NULL;
+        avl_key_t key = avl_node_buffer[i].key;
+        avl_node_t *pivot = avl_tree_split(avl_tree.root, key, &left, &right);
+        assert(pivot == &avl_node_buffer[i]);
+        (void)avl_tree_check(left, NULL);
+        (void)avl_tree_check(right, NULL);
+        for (int j = 0; j < MAX_NODES; j++) {
+            avl_key_t other = avl_node_buffer[j].key;
+            assert(avl_tree_node_lookup((other < key) ? left : right, other) ==
+                   ((other == key) ? NULL : &avl_node_buffer[j]));
+            (void)other;
+        }
+        avl_tree.root = avl_tree_join(left, pivot, right);
+        (void)avl_tree_check(avl_tree.root, NULL);
+
+        // Split at a missing key: one more than the largest key never exists.
+        pivot = avl_tree_split(avl_tree.root, key + (10 * MAX_NODES) + 1, &left, &right);
+        assert((NULL == pivot) && (NULL == right));
+        (void)avl_tree_check(left, NULL);
+        avl_tree.root = left;
+    }
+    printf("Split / join passed\n");
+    avl_tree.root = NULL;
+    printf("------------------------\n");
+}
+
+static inline void test_remove_nodes_by_pointer(void) {
+    printf("\n------------------------\n");
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
+    }
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_node_t *node = &avl_node_buffer[(i * 7) % MAX_NODES];
+        avl_tree.root = avl_tree_remove_node_ptr(avl_tree.root, node);
+        assert(NULL == avl_tree_node_lookup(avl_tree.root, node->key));
+        if (0 == (i % 64)) {
+            (void)avl_tree_check(avl_tree.root, NULL);
+        }
+    }
+    assert(NULL == avl_tree.root);
+    printf("Remove by pointer passed\n");
+    printf("------------------------\n");
+}
 
 int main(int argc, char *argv[]) {
     (void)argc;
@@ -182,22 +333,42 @@ int main(int argc, char *argv[]) {
 
     test_insert_nodes_in_order();
     test_find_all_nodes();
+    test_iterate();
+    test_bounds();
+    test_insert_or_get();
     test_remove_nodes_in_order();
 
     test_insert_nodes_in_reverse_order();
     test_find_all_nodes();
     test_remove_nodes_in_reverse_order();
 
+    test_rebalance_levels();
+
+    test_build_sorted();
+    test_find_all_nodes();
+    test_iterate();
+    test_bounds();
+    test_insert_or_get();
+    test_remove_nodes_in_order();
+
     // Second, test with random keys
     test_avl_node_buffer_init_random();
 
     test_insert_nodes_in_order();
     test_find_all_nodes();
+    test_iterate();
+    test_bounds();
+    test_insert_or_get();
     test_remove_nodes_in_order();
 
     test_insert_nodes_in_reverse_order();
     test_find_all_nodes();
     test_remove_nodes_in_reverse_order();
 
+    test_rebalance_levels();
+
+    test_split_join();
+    test_remove_nodes_by_pointer();
+
     return 0;
 }
@@ -0,0 +1,52 @@
+#ifndef TEST_AVL_TREE_CHECK_H
+#define TEST_AVL_TREE_CHECK_H
+
+#include <assert.h>
+
+#include "avl_tree.h"
+
+/*
+ * Structural validator shared by the tests, for every node layout selected with compile
+ * definitions.
+ */
+
+// NOLINTBEGIN(misc-no-recursion)
+// Recursion: this is a test helper, recursion is OK here
+// Check parents, order by node_cmp, balance, heights and sizes of the whole subtree, return its
+// height.
+static inline int avl_tree_check_by(avl_node_t *node, avl_node_t *parent,
+                                    avl_node_search_cmp_t node_cmp) {
+    int height = 0;
+    if (NULL != node) {
+        avl_node_t *left = avl_node_left(node);
+        avl_node_t *right = avl_node_right(node);
+#ifndef AVL_TREE_NODE_NO_PARENT
+        assert(avl_node_parent(node) == parent);
+#endif
+        (void)parent;
+        if (NULL != left) {
+            assert(AVL_CMP_GT == node_cmp(node, left));
+        }
+        if (NULL != right) {
+            assert(AVL_CMP_LT == node_cmp(node, right));
+        }
+        int left_height = avl_tree_check_by(left, node, node_cmp);
+        int right_height = avl_tree_check_by(right, node, node_cmp);
+        assert((left_height - right_height <= 1) && (right_height - left_height <= 1));
+        height = 1 + ((left_height > right_height) ? left_height : right_height);
+        assert(avl_node_balance_factor(node) == right_height - left_height);
+        assert((int)avl_node_height(node) == height);
+#ifdef AVL_TREE_ORDER_STATISTICS
+        assert(avl_node_size(node) == avl_node_size(left) + avl_node_size(right) + 1U);
+#endif
+    }
+    return height;
+}
+// NOLINTEND(misc-no-recursion)
+
+// Check a subtree ordered by avl_node_cmp(), return its height.
+static inline int avl_tree_check(avl_node_t *node, avl_node_t *parent) {
+    return avl_tree_check_by(node, parent, avl_node_search_node_cmp);
+}
+
+#endif // TEST_AVL_TREE_CHECK_H
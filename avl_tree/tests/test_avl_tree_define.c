@@ -0,0 +1,333 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "avl_tree_define.h"
+#include "test_avl_tree_check.h"
+
+/*
+ * Several differently keyed trees generated with AVL_TREE_DEFINE() in one translation unit,
+ * next to the avl_node_t tree of avl_tree.h, all in the layout selected by the build. The nodes
+ * hold links only, the key of the avl_tree.h tree is right before its node.
+ */
+
+#define MAX_NODES 1024
+#define OTHER_NODES (MAX_NODES / 8)
+#define NAME_SIZE 16
+
+typedef struct small_node {
+    avl_node_t node;
+    uint32_t id;
+} small_node_t;
+
+typedef struct reverse_node {
+    uint64_t weight;
+    avl_node_t link;
+} reverse_node_t;
+
+typedef struct name_key {
+    char text[NAME_SIZE];
+} name_key_t;
+
+typedef struct name_node {
+    avl_node_t node;
+    name_key_t name;
+    uint32_t value;
+} name_node_t;
+
+typedef struct plain_item {
+    avl_key_t key;
+    avl_node_t node;
+} plain_item_t;
+
+_Static_assert(AVL_NODE_KEY_OFFSET(plain_item_t, node, key) == AVL_TREE_NODE_KEY_OFFSET,
+               "key of plain_item_t not at AVL_TREE_NODE_KEY_OFFSET");
+
+#define SMALL_KEY_CMP(a, b) ((*(a) > *(b)) - (*(a) < *(b)))
+
+static inline int reverse_key_cmp(const uint64_t *a, const uint64_t *b) {
+    return (*a < *b) - (*a > *b);
+}
+
+static inline int name_key_cmp(const name_key_t *a, const name_key_t *b) {
+    return strncmp(a->text, b->text, NAME_SIZE);
+}
+
+AVL_TREE_DEFINE(small_tree, small_node_t, node, uint32_t, id, SMALL_KEY_CMP)
+AVL_TREE_DEFINE(reverse_tree, reverse_node_t, link, uint64_t, weight, reverse_key_cmp)
+AVL_TREE_DEFINE(name_tree, name_node_t, node, name_key_t, name, name_key_cmp)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static small_node_t small_nodes[MAX_NODES];
+static small_node_t other_nodes[OTHER_NODES];
+static reverse_node_t reverse_nodes[MAX_NODES];
+static name_node_t name_nodes[MAX_NODES];
+static plain_item_t plain_items[MAX_NODES];
+static uint32_t order[MAX_NODES];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Check shape and order of a generated tree, count_out receives the number of nodes.
+#define TEST_TREE_CHECK(prefix, node_type, root_node, count_out)                                   \
+    do {                                                                                           \
+        (void)avl_tree_check_by(root_node, NULL, prefix##_node_cmp);                               \
+        (count_out) = 0;                                                                           \
+        for (node_type *node = prefix##_first(root_node); NULL != node;                            \
+             node = prefix##_next(root_node, node)) {                                              \
+            (count_out)++;                                                                         \
+        }                                                                                          \
+    } while (0)
+
+static inline void test_order_shuffle(void) {
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        order[i] = i;
+    }
+    for (uint32_t i = MAX_NODES - 1U; i > 0U; i--) {
+        // NOLINTNEXTLINE -- limited randomness is acceptable, concurrency excluded
+        uint32_t j = (uint32_t)rand() % (i + 1U);
+        uint32_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+static inline avl_node_t *test_small_tree_build(void) {
+    avl_node_t *root = NULL;
+    test_order_shuffle();
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        small_nodes[order[i]].id = 2U * order[i];
+        root = small_tree_insert(root, &small_nodes[order[i]]);
+    }
+    return root;
+}
+
+static inline void test_small_tree(void) {
+    printf("\n------------------------\n");
+    avl_node_t *root = test_small_tree_build();
+    int checked_count = 0;
+    TEST_TREE_CHECK(small_tree, small_node_t, root, checked_count);
+    assert(MAX_NODES == checked_count);
+
+    for (uint32_t key = 0; key < (2U * MAX_NODES) - 1U; key++) {
+        bool found = (0U == (key % 2U));
+        assert(small_tree_lookup(root, &key) == (found ? &small_nodes[key / 2U] : NULL));
+        assert(small_tree_lower_bound(root, &key) == &small_nodes[(key + 1U) / 2U]);
+        assert(small_tree_ceiling(root, &key) == &small_nodes[(key + 1U) / 2U]);
+        uint32_t above = (key / 2U) + 1U;
+        assert(small_tree_upper_bound(root, &key) ==
+               ((above < MAX_NODES) ? &small_nodes[above] : NULL));
+        assert(small_tree_floor(root, &key) == &small_nodes[key / 2U]);
+        (void)found;
+        (void)above;
+    }
+    uint32_t beyond = (2U * MAX_NODES) - 1U;
+    assert(NULL == small_tree_lower_bound(root, &beyond));
+    assert(small_tree_floor(root, &beyond) == &small_nodes[MAX_NODES - 1]);
+    assert(small_tree_prev(root, &small_nodes[0]) == NULL);
+    assert(small_tree_prev(root, &small_nodes[5]) == &small_nodes[4]);
+
+    // Closed range starting between keys and running past the last one.
+    uint32_t lo = 11U;
+    small_tree_range_t range;
+    small_tree_range_begin(&range, root, &lo, &beyond);
+    for (uint32_t i = 6U; i < MAX_NODES; i++) {
+        assert(small_tree_range_next(&range) == &small_nodes[i]);
+    }
+    assert(NULL == small_tree_range_next(&range));
+
+    // Duplicate keys are not inserted.
+    small_node_t duplicate = {.id = 6U};
+    small_node_t *existing = NULL;
+    avl_node_t *unchanged_root = small_tree_insert_or_get(root, &duplicate, &existing);
+    assert((unchanged_root == root) && (&small_nodes[3] == existing));
+    (void)unchanged_root;
+
+    for (uint32_t i = 0; i < MAX_NODES; i += 2U) {
+        root = small_tree_remove_node_ptr(root, &small_nodes[order[i]]);
+        uint32_t key = 2U * order[i + 1U];
+        root = small_tree_remove_node(root, &key);
+        if (0U == (i % 64U)) {
+            TEST_TREE_CHECK(small_tree, small_node_t, root, checked_count);
+            assert((int)(MAX_NODES - i - 2U) == checked_count);
+        }
+    }
+    assert(NULL == root);
+    printf("Generated tree with 32-bit keys passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_small_tree_split_join(void) {
+    printf("\n------------------------\n");
+    avl_node_t *root = test_small_tree_build();
+    int checked_count = 0;
+    for (uint32_t i = 0; i < MAX_NODES; i += 37U) {
+        avl_node_t *left = NULL;
+        avl_node_t *right = NULL;
+        uint32_t key = 2U * i;
+        small_node_t *pivot = small_tree_split(root, &key, &left, &right);
+        assert(pivot == &small_nodes[i]);
+        TEST_TREE_CHECK(small_tree, small_node_t, left, checked_count);
+        assert((int)i == checked_count);
+        TEST_TREE_CHECK(small_tree, small_node_t, right, checked_count);
+        assert((int)(MAX_NODES - i - 1U) == checked_count);
+        root = small_tree_join(left, pivot, right);
+    }
+    TEST_TREE_CHECK(small_tree, small_node_t, root, checked_count);
+    assert(MAX_NODES == checked_count);
+#ifdef AVL_TREE_ORDER_STATISTICS
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        uint32_t key = (2U * i) + 1U;
+        assert(small_tree_select(root, i) == &small_nodes[i]);
+        assert(small_tree_rank(root, &key) == (i + 1U));
+        uint32_t lo = 2U * i;
+        assert(small_tree_count_range(root, &lo, &key) == 1U);
+        (void)key;
+        (void)lo;
+    }
+#endif
+    printf("Generated tree split / join passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_small_tree_set_operations(void) {
+    printf("\n------------------------\n");
+    avl_tree_t tree = {.root = NULL};
+    avl_tree_t other = {.root = NULL};
+    avl_tree_t removed = {.root = NULL};
+    avl_tree_t duplicates = {.root = NULL};
+    const avl_size_t shared = OTHER_NODES / 2;
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        small_nodes[i].id = 2U * i;
+        small_node_t *inserted = small_tree_tree_insert(&tree, &small_nodes[i]);
+        assert(inserted == &small_nodes[i]);
+        (void)inserted;
+    }
+    // Even other nodes share a key with a node, odd ones have odd keys no node has.
+    for (uint32_t j = 0; j < OTHER_NODES; j++) {
+        other_nodes[j].id = (0U == (j % 2U)) ? (14U * j) : ((2U * j) + 1U);
+        small_node_t *inserted = small_tree_tree_insert(&other, &other_nodes[j]);
+        assert(inserted == &other_nodes[j]);
+        (void)inserted;
+    }
+    small_node_t *node = small_tree_tree_insert(&tree, &other_nodes[0]);
+    assert(node == &small_nodes[0]);
+
+    avl_size_t count = small_tree_tree_intersection(&tree, &other, &removed);
+    assert(count == shared);
+    assert((shared == avl_tree_count(&tree)) && ((MAX_NODES - shared) == avl_tree_count(&removed)));
+    assert(small_tree_tree_peek_min(&tree) == &small_nodes[0]);
+    assert(small_tree_tree_peek_max(&tree) == &small_nodes[7U * (OTHER_NODES - 2U)]);
+    count = small_tree_tree_union(&tree, &removed, &duplicates);
+    assert(0U == count);
+    assert((MAX_NODES == avl_tree_count(&tree)) && (NULL == removed.root));
+
+    count = small_tree_tree_difference(&tree, &other, &removed);
+    assert((count == shared) && ((MAX_NODES - shared) == avl_tree_count(&tree)));
+    count = small_tree_tree_union(&tree, &removed, NULL);
+    assert(0U == count);
+
+    // Nodes keep their places, the other nodes with a shared key end up in duplicates.
+    count = small_tree_tree_union(&tree, &other, &duplicates);
+    assert((count == shared) && (NULL == other.root));
+    assert(shared == avl_tree_count(&duplicates));
+    int checked_count = 0;
+    TEST_TREE_CHECK(small_tree, small_node_t, tree.root, checked_count);
+    assert((MAX_NODES + OTHER_NODES - shared) == (avl_size_t)checked_count);
+    for (uint32_t j = 1; j < OTHER_NODES; j += 2U) {
+        node = small_tree_tree_remove_key(&tree, &other_nodes[j].id);
+        assert(node == &other_nodes[j]);
+    }
+    node = small_tree_tree_remove_key(&tree, &other_nodes[1].id);
+    assert(NULL == node);
+
+    for (uint32_t i = 0; i < MAX_NODES / 2U; i++) {
+        node = small_tree_tree_pop_min(&tree);
+        assert(node == &small_nodes[i]);
+        node = small_tree_tree_pop_max(&tree);
+        assert(node == &small_nodes[MAX_NODES - 1U - i]);
+    }
+    node = small_tree_tree_pop_min(&tree);
+    assert((NULL == node) && (0U == avl_tree_count(&tree)));
+    (void)node;
+    (void)count;
+    (void)shared;
+    printf("Generated tree set operations passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_reverse_tree(void) {
+    printf("\n------------------------\n");
+    avl_node_t *root = NULL;
+    int checked_count = 0;
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        reverse_nodes[i].weight = (uint64_t)i << 32U;
+        root = reverse_tree_insert(root, &reverse_nodes[i]);
+    }
+    TEST_TREE_CHECK(reverse_tree, reverse_node_t, root, checked_count);
+    assert(MAX_NODES == checked_count);
+    // Descending order: the greatest key comes first.
+    assert(reverse_tree_first(root) == &reverse_nodes[MAX_NODES - 1]);
+    assert(reverse_tree_last(root) == &reverse_nodes[0]);
+    assert(reverse_tree_prev(root, &reverse_nodes[5]) == &reverse_nodes[6]);
+    assert(NULL == reverse_tree_prev(root, reverse_tree_first(root)));
+    uint64_t key = ((uint64_t)7U << 32U) + 1U;
+    assert(reverse_tree_lower_bound(root, &key) == &reverse_nodes[7]);
+    (void)key;
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        root = reverse_tree_remove_node_ptr(root, &reverse_nodes[i]);
+    }
+    assert(NULL == root);
+    printf("Generated tree with descending order passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_name_tree(void) {
+    printf("\n------------------------\n");
+    avl_node_t *root = NULL;
+    avl_node_t *plain_root = NULL;
+    int checked_count = 0;
+    test_order_shuffle();
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        name_node_t *node = &name_nodes[order[i]];
+        (void)snprintf(node->name.text, NAME_SIZE, "name-%05u", order[i]);
+        node->value = order[i];
+        root = name_tree_insert(root, node);
+        // The avl_tree.h tree lives in the same translation unit.
+        plain_items[i].key = order[i];
+        plain_root = avl_tree_node_insert(plain_root, &plain_items[i].node);
+    }
+    TEST_TREE_CHECK(name_tree, name_node_t, root, checked_count);
+    assert(MAX_NODES == checked_count);
+
+    for (uint32_t i = 0; i < MAX_NODES; i++) {
+        name_key_t key;
+        (void)snprintf(key.text, NAME_SIZE, "name-%05u", i);
+        name_node_t *node = name_tree_lookup(root, &key);
+        assert((NULL != node) && (node->value == i));
+        assert(avl_node_key(avl_tree_node_lookup(plain_root, i)) == i);
+        (void)node;
+    }
+    name_key_t missing = {.text = "name-"};
+    assert(NULL == name_tree_lookup(root, &missing));
+    assert(name_tree_lower_bound(root, &missing) == &name_nodes[0]);
+    (void)missing;
+    printf("Generated tree with string keys passed\n");
+    printf("------------------------\n");
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    uint32_t random_seed = (uint32_t)time(NULL);
+    printf("Using random_seed: %u\n", random_seed);
+    srand(random_seed);
+
+    test_small_tree();
+    test_small_tree_split_join();
+    test_small_tree_set_operations();
+    test_reverse_tree();
+    test_name_tree();
+    return 0;
+}
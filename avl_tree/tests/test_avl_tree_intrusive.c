@@ -0,0 +1,236 @@
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// The key is stored in the item right before its node, see test_item_t.
+#define AVL_TREE_NODE_KEY_OFFSET (-(ptrdiff_t)sizeof(avl_key_t))
+
+#include "avl_tree.h"
+
+/*
+ * Nodes embedded into items that hold the key themselves, for a configuration variant selected
+ * with compile definitions, see CMakeLists.txt for the built variants.
+ */
+
+#define MAX_ITEMS 1024
+#define OTHER_ITEMS (MAX_ITEMS / 8)
+#define PAYLOAD_WORDS 4
+
+typedef struct {
+    avl_key_t key;
+    avl_node_t node;
+    uint32_t payload[PAYLOAD_WORDS];
+} test_item_t;
+
+_Static_assert(AVL_NODE_KEY_OFFSET(test_item_t, node, key) == AVL_TREE_NODE_KEY_OFFSET,
+               "key must be right before the node");
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static test_item_t items[MAX_ITEMS];
+static test_item_t other_items[OTHER_ITEMS];
+static uint32_t order[MAX_ITEMS];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+static inline test_item_t *test_item_of(avl_node_t *node) {
+    return (NULL == node) ? NULL : AVL_CONTAINER_OF(node, test_item_t, node);
+}
+
+// Count the nodes of a tree, asserting ascending keys read through the containers.
+static inline avl_size_t test_tree_count_sorted(avl_node_t *root) {
+    avl_size_t count = 0;
+    avl_node_t *prev = NULL;
+    for (avl_node_t *node = avl_tree_first(root); NULL != node;
+         node = avl_tree_node_next(root, node)) {
+        assert((NULL == prev) || (test_item_of(prev)->key < test_item_of(node)->key));
+        prev = node;
+        count++;
+    }
+    (void)prev;
+    return count;
+}
+
+static inline void test_items_init(void) {
+    for (uint32_t i = 0; i < MAX_ITEMS; i++) {
+        items[i].key = 3U * (avl_key_t)i + 1U;
+        for (uint32_t j = 0; j < PAYLOAD_WORDS; j++) {
+            items[i].payload[j] = i ^ j;
+        }
+        order[i] = i;
+    }
+    for (uint32_t i = MAX_ITEMS - 1U; i > 0U; i--) {
+        // NOLINTNEXTLINE -- limited randomness is acceptable, concurrency excluded
+        uint32_t j = (uint32_t)rand() % (i + 1U);
+        uint32_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+}
+
+static inline void test_insert_lookup(avl_tree_t *tree) {
+    printf("\n------------------------\n");
+    for (uint32_t i = 0; i < MAX_ITEMS; i++) {
+        test_item_t *item = &items[order[i]];
+        avl_node_t *inserted = avl_tree_insert(tree, &item->node);
+        assert(inserted == &item->node);
+        (void)inserted;
+    }
+    assert(MAX_ITEMS == avl_tree_count(tree));
+
+    for (uint32_t i = 0; i < MAX_ITEMS; i++) {
+        test_item_t *item = test_item_of(avl_tree_node_lookup(tree->root, items[i].key));
+        assert((item == &items[i]) && (item->payload[1] == (i ^ 1U)));
+        assert(NULL == avl_tree_node_lookup(tree->root, items[i].key + 1U));
+        assert(test_item_of(avl_tree_node_lower_bound(tree->root, items[i].key - 1U)) ==
+               &items[i]);
+        (void)item;
+    }
+
+    // In-order iteration reads the keys through the containers.
+    uint32_t index = 0;
+    for (avl_node_t *node = avl_tree_first(tree->root); NULL != node;
+         node = avl_tree_node_next(tree->root, node)) {
+        assert(test_item_of(node) == &items[index]);
+        assert(avl_node_key(node) == items[index].key);
+        index++;
+    }
+    assert(MAX_ITEMS == index);
+
+    avl_tree_range_t range;
+    avl_tree_range_begin(&range, tree->root, items[10].key, items[20].key);
+    for (index = 10; index <= 20; index++) {
+        assert(test_item_of(avl_tree_range_next(&range)) == &items[index]);
+    }
+    assert(NULL == avl_tree_range_next(&range));
+    // A range starting between keys and running past the maximum walks all remaining items.
+    avl_tree_range_begin(&range, tree->root, items[10].key + 1U, items[MAX_ITEMS - 1U].key + 1U);
+    for (index = 11; index < MAX_ITEMS; index++) {
+        assert(test_item_of(avl_tree_range_next(&range)) == &items[index]);
+    }
+    assert(NULL == avl_tree_range_next(&range));
+    printf("Intrusive insert / lookup passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_snapshot(avl_tree_t *tree) {
+    printf("\n------------------------\n");
+    static avl_key_t keys[2 * MAX_ITEMS];
+    static avl_node_t *nodes[MAX_ITEMS];
+    avl_tree_fat_leaf_t snapshot = {.keys = keys, .nodes = nodes, .count = 0, .levels = 0};
+    avl_size_t exported = avl_tree_fat_leaf_export(&snapshot, tree->root, 2 * MAX_ITEMS);
+    assert(MAX_ITEMS == exported);
+    (void)exported;
+    for (uint32_t i = 0; i < MAX_ITEMS; i++) {
+        assert(test_item_of(nodes[avl_tree_fat_leaf_search(&snapshot, items[i].key)]) ==
+               &items[i]);
+    }
+    printf("Intrusive snapshot passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_split_join(avl_tree_t *tree) {
+    printf("\n------------------------\n");
+    for (uint32_t i = 0; i < MAX_ITEMS; i += 37U) {
+        avl_node_t *left = NULL;
+        avl_node_t *right = NULL;
+        avl_node_t *pivot = avl_tree_split(tree->root, items[i].key, &left, &right);
+        assert(test_item_of(pivot) == &items[i]);
+        assert((i == test_tree_count_sorted(left)) &&
+               ((MAX_ITEMS - i - 1U) == test_tree_count_sorted(right)));
+        assert((NULL == left) || (avl_node_key(avl_tree_last(left)) < items[i].key));
+        assert((NULL == right) || (avl_node_key(avl_tree_first(right)) > items[i].key));
+        tree->root = avl_tree_join(left, pivot, right);
+        assert(MAX_ITEMS == test_tree_count_sorted(tree->root));
+    }
+    printf("Intrusive split / join passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_set_operations(avl_tree_t *tree) {
+    printf("\n------------------------\n");
+    avl_tree_t other = {.root = NULL};
+    avl_tree_t removed = {.root = NULL};
+    avl_tree_t duplicates = {.root = NULL};
+    const avl_size_t shared = OTHER_ITEMS / 2;
+
+    // Even other items share a key with an item, odd ones have keys no item has.
+    for (uint32_t j = 0; j < OTHER_ITEMS; j++) {
+        other_items[j].key = (0U == (j % 2U)) ? items[(j * 7U) % MAX_ITEMS].key : (3U * j) + 2U;
+        avl_node_t *inserted = avl_tree_insert(&other, &other_items[j].node);
+        assert(inserted == &other_items[j].node);
+        (void)inserted;
+    }
+
+    avl_size_t matches = avl_tree_intersection(tree, &other, &removed);
+    assert(shared == matches);
+    assert((shared == test_tree_count_sorted(tree->root)) && (shared == avl_tree_count(tree)));
+    assert((MAX_ITEMS - shared) == test_tree_count_sorted(removed.root));
+    for (uint32_t j = 0; j < OTHER_ITEMS; j += 2U) {
+        assert(test_item_of(avl_tree_node_lookup(tree->root, other_items[j].key)) ==
+               &items[(j * 7U) % MAX_ITEMS]);
+    }
+    matches = avl_tree_union(tree, &removed, &duplicates);
+    assert((0U == matches) && (NULL == removed.root) && (NULL == duplicates.root));
+
+    matches = avl_tree_difference(tree, &other, &removed);
+    assert(shared == matches);
+    assert((MAX_ITEMS - shared) == test_tree_count_sorted(tree->root));
+    assert(shared == test_tree_count_sorted(removed.root));
+    matches = avl_tree_union(tree, &removed, NULL);
+    assert((0U == matches) && (MAX_ITEMS == test_tree_count_sorted(tree->root)));
+
+    // Items keep their nodes, the other items with a shared key end up in duplicates.
+    matches = avl_tree_union(tree, &other, &duplicates);
+    assert((shared == matches) && (NULL == other.root));
+    assert(shared == test_tree_count_sorted(duplicates.root));
+    assert((MAX_ITEMS + OTHER_ITEMS - shared) == test_tree_count_sorted(tree->root));
+    for (uint32_t i = 0; i < MAX_ITEMS; i++) {
+        assert(test_item_of(avl_tree_node_lookup(tree->root, items[i].key)) == &items[i]);
+    }
+    for (uint32_t j = 1; j < OTHER_ITEMS; j += 2U) {
+        assert(test_item_of(avl_tree_node_lookup(tree->root, other_items[j].key)) ==
+               &other_items[j]);
+        avl_tree_remove(tree, &other_items[j].node);
+    }
+    assert(MAX_ITEMS == avl_tree_count(tree));
+    (void)matches;
+    (void)shared;
+    printf("Intrusive set operations passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_remove(avl_tree_t *tree) {
+    printf("\n------------------------\n");
+    for (uint32_t i = 0; i < MAX_ITEMS; i += 2U) {
+        avl_tree_remove(tree, &items[order[i]].node);
+        avl_node_t *removed = avl_tree_remove_key(tree, items[order[i + 1U]].key);
+        assert(test_item_of(removed) == &items[order[i + 1U]]);
+        (void)removed;
+        assert(NULL == avl_tree_node_lookup(tree->root, items[order[i]].key));
+    }
+    assert((NULL == tree->root) && (0U == avl_tree_count(tree)));
+    printf("Intrusive remove passed\n");
+    printf("------------------------\n");
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    avl_tree_t tree = {.root = NULL};
+    printf("Size of avl_node_t: %zu Bytes, of test_item_t: %zu Bytes.\n", sizeof(avl_node_t),
+           sizeof(test_item_t));
+
+    uint32_t random_seed = (uint32_t)time(NULL);
+    printf("Using random_seed: %u\n", random_seed);
+    srand(random_seed);
+
+    test_items_init();
+    test_insert_lookup(&tree);
+    test_snapshot(&tree);
+    test_split_join(&tree);
+    test_set_operations(&tree);
+    test_remove(&tree);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t pool_exhausted_reports = 0;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+#define AVL_TREE_POOL_EXHAUSTED_HOOK(pool)                                                         \
+    do {                                                                                           \
+        (void)(pool);                                                                              \
+        pool_exhausted_reports++;                                                                  \
+    } while (0)
+
+#include "avl_tree_pool.h"
+
+/*
+ * Key-only tree fed from a fixed-capacity node pool, for a configuration variant selected with
+ * compile definitions, see CMakeLists.txt for the built variants.
+ */
+
+#define POOL_CAPACITY 1024
+#define MAX_KEY (4 * POOL_CAPACITY)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// Static storage, with AVL_TREE_NODE_INDEX_LINKS it is the AVL_TREE_NODE_POOL array.
+avl_node_t avl_node_pool[POOL_CAPACITY];
+static uint64_t avl_node_pool_map[AVL_NODE_POOL_MAP_WORDS(POOL_CAPACITY)];
+static bool key_inserted[MAX_KEY];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+static inline void test_pool_fill(avl_tree_t *tree, avl_node_pool_t *pool) {
+    printf("\n------------------------\n");
+    avl_node_pool_init(pool, avl_node_pool, POOL_CAPACITY, avl_node_pool_map);
+    for (avl_key_t key = 0; key < POOL_CAPACITY; key++) {
+        avl_node_t *node = avl_tree_pool_insert(tree, pool, 2U * key);
+        // Untouched nodes are handed out in storage order.
+        assert((node == &avl_node_pool[key]) && (node->key == 2U * key));
+        key_inserted[2U * key] = true;
+        // Duplicates give their untouched node back, the high-water mark stays the peak in use.
+        for (int i = 0; i < 4; i++) {
+            avl_node_t *existing = avl_tree_pool_insert(tree, pool, 2U * key);
+            assert(existing == node);
+            (void)existing;
+        }
+        assert(((key + 1U) == pool->used) && ((key + 1U) == pool->high_water));
+        (void)node;
+    }
+    assert((POOL_CAPACITY == pool->used) && (POOL_CAPACITY == pool->high_water));
+    assert(POOL_CAPACITY == avl_tree_count(tree));
+
+    // Existing keys are still found with the pool full, new ones are reported.
+    avl_node_t *node = avl_tree_pool_insert(tree, pool, 6U);
+    assert((node == &avl_node_pool[3]) && (0U == pool->exhausted));
+    assert(0U == pool_exhausted_reports);
+    node = avl_tree_pool_insert(tree, pool, 1U);
+    assert(NULL == node);
+    node = avl_node_pool_alloc(pool);
+    assert(NULL == node);
+    assert((2U == pool->exhausted) && (2U == pool_exhausted_reports));
+    (void)node;
+    assert(POOL_CAPACITY == pool->used);
+    printf("Pool fill and exhaustion passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_pool_reuse(avl_tree_t *tree, avl_node_pool_t *pool) {
+    printf("\n------------------------\n");
+    // The most recently released node is reused first.
+    avl_node_t *removed = avl_tree_node_lookup(tree->root, 10U);
+    bool found = avl_tree_pool_remove(tree, pool, 10U);
+    assert(found);
+    key_inserted[10] = false;
+    found = avl_tree_pool_remove(tree, pool, 10U);
+    assert(!found);
+    avl_node_t *node = avl_tree_pool_insert(tree, pool, 11U);
+    assert(node == removed);
+    key_inserted[11] = true;
+    // A duplicate takes no node, the free list keeps its order.
+    found = avl_tree_pool_remove(tree, pool, 12U);
+    assert(found);
+    key_inserted[12] = false;
+    removed = pool->free_list;
+    node = avl_tree_pool_insert(tree, pool, 14U);
+    assert(node != removed);
+    assert((pool->free_list == removed) && ((POOL_CAPACITY - 1U) == pool->used));
+
+    // Random churn never grows beyond the storage.
+    for (int i = 0; i < 16 * POOL_CAPACITY; i++) {
+        // NOLINTNEXTLINE -- limited randomness is acceptable, concurrency excluded
+        avl_key_t key = (avl_key_t)(rand() % MAX_KEY);
+        if (key_inserted[key]) {
+            found = avl_tree_pool_remove(tree, pool, key);
+            assert(found);
+            key_inserted[key] = false;
+        } else if (pool->used < POOL_CAPACITY) {
+            node = avl_tree_pool_insert(tree, pool, key);
+            assert((NULL != node) && (node->key == key));
+            key_inserted[key] = true;
+        }
+        assert(pool->used == avl_tree_count(tree));
+    }
+    assert(POOL_CAPACITY == pool->high_water);
+    for (avl_key_t key = 0; key < MAX_KEY; key++) {
+        assert((NULL != avl_tree_node_lookup(tree->root, key)) == key_inserted[key]);
+        if (key_inserted[key]) {
+            found = avl_tree_pool_remove(tree, pool, key);
+            assert(found);
+        }
+    }
+    assert((NULL == tree->root) && (0U == pool->used));
+    (void)found;
+    (void)node;
+    (void)removed;
+    printf("Pool reuse passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_pool_locality(avl_tree_t *tree, avl_node_pool_t *pool) {
+    printf("\n------------------------\n");
+    avl_node_pool_init(pool, avl_node_pool, POOL_CAPACITY, avl_node_pool_map);
+    for (avl_key_t key = 0; key < POOL_CAPACITY; key++) {
+        avl_node_t *node = avl_tree_pool_insert(tree, pool, 4U * key);
+        assert(node == &avl_node_pool[key]);
+        (void)node;
+    }
+    bool found = avl_tree_pool_remove(tree, pool, 4U * 100U);
+    assert(found);
+    found = avl_tree_pool_remove(tree, pool, 4U * 900U);
+    assert(found);
+    assert(pool->free_list == &avl_node_pool[900]);
+
+    // The parent of 401 holds 396 or 404, the released node between them is taken, not the most
+    // recently released one.
+    avl_node_t *node = avl_tree_pool_insert(tree, pool, (4U * 100U) + 1U);
+    assert((node == &avl_node_pool[100]) && (pool->free_list == &avl_node_pool[900]));
+    // No released node in the region of the parent, the free list is next.
+    node = avl_tree_pool_insert(tree, pool, 1U);
+    assert((node == &avl_node_pool[900]) && (NULL == pool->free_list));
+    assert((POOL_CAPACITY == pool->used) && (POOL_CAPACITY == pool->high_water));
+
+    for (avl_key_t key = 0; key < POOL_CAPACITY; key++) {
+        found = avl_tree_pool_remove(tree, pool, 4U * key);
+        assert(found == ((100U != key) && (900U != key)));
+    }
+    found = avl_tree_pool_remove(tree, pool, (4U * 100U) + 1U);
+    assert(found);
+    found = avl_tree_pool_remove(tree, pool, 1U);
+    assert(found && (NULL == tree->root) && (0U == pool->used));
+    (void)found;
+    (void)node;
+    printf("Pool locality passed\n");
+    printf("------------------------\n");
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    avl_tree_t tree = {.root = NULL};
+    avl_node_pool_t pool;
+    uint32_t random_seed = (uint32_t)time(NULL);
+    printf("Using random_seed: %u\n", random_seed);
+    srand(random_seed);
+
+    test_pool_fill(&tree, &pool);
+    test_pool_reuse(&tree, &pool);
+    test_pool_locality(&tree, &pool);
+    return 0;
+}
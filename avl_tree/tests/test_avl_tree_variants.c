@@ -0,0 +1,504 @@
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "avl_tree.h"
+#include "test_avl_tree_check.h"
+
+/*
+ * Exercises the AVL Tree API for a configuration variant selected with compile definitions,
+ * see CMakeLists.txt for the built variants.
+ */
+
+#define MAX_NODES 1024
+#define MAX_KEY (10 * MAX_NODES)
+#define OTHER_NODES (MAX_NODES / 8)
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+// All nodes come from one pool, as AVL_TREE_NODE_INDEX_LINKS requires.
+avl_node_t avl_node_pool[MAX_NODES + OTHER_NODES + 1];
+static avl_node_t *const avl_node_buffer = &avl_node_pool[0];
+static avl_node_t *const avl_node_buffer_other = &avl_node_pool[MAX_NODES];
+static avl_node_t *const avl_node_spare = &avl_node_pool[MAX_NODES + OTHER_NODES];
+static avl_tree_t avl_tree = {.root = NULL};
+static bool avl_node_inserted[MAX_NODES];
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
+// NOLINTBEGIN(misc-no-recursion)
+// Recursion: this is a test helper, recursion is OK here
+// Count nodes of a subtree, asserting each one is (not) in the other tree.
+static inline int avl_tree_count_in(avl_node_t *node, avl_node_t *other, bool expect_in) {
+    int count = 0;
+    if (NULL != node) {
+        assert((NULL != avl_tree_node_lookup(other, node->key)) == expect_in);
+        count = 1 + avl_tree_count_in(avl_node_left(node), other, expect_in) +
+                avl_tree_count_in(avl_node_right(node), other, expect_in);
+    }
+    return count;
+}
+// NOLINTEND(misc-no-recursion)
+
+#ifdef AVL_TREE_KEY_CMP_FN_EXTERNAL
+// Same order as the default comparison, reached through the external hook.
+avl_node_cmp_result_t avl_node_key_cmp(const avl_key_t *key, const avl_node_t *node) {
+    return (*key == node->key) ? AVL_CMP_EQ : ((*key < node->key) ? AVL_CMP_LT : AVL_CMP_GT);
+}
+#endif
+
+#ifdef AVL_TREE_NODE_CMP_FN_EXTERNAL
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+static uint32_t node_cmp_calls = 0;
+
+// Same order as the default comparison, counting calls to check that lookups reach it too.
+avl_node_cmp_result_t avl_node_cmp(avl_node_t *node_a, avl_node_t *node_b) {
+    node_cmp_calls++;
+    return (node_a->key == node_b->key) ? AVL_CMP_EQ
+                                        : ((node_a->key < node_b->key) ? AVL_CMP_LT : AVL_CMP_GT);
+}
+#endif
+
+static inline void avl_tree_handle_check(avl_tree_t *tree) {
+    avl_size_t count = 0;
+    for (avl_node_t *node = avl_tree_first(tree->root); NULL != node;
+         node = avl_tree_node_next(tree->root, node)) {
+        count++;
+    }
+    assert(avl_tree_count(tree) == count);
+    (void)avl_tree_check(tree->root, NULL);
+    assert(avl_tree_peek_min(tree) == avl_tree_first(tree->root));
+    assert(avl_tree_peek_max(tree) == avl_tree_last(tree->root));
+}
+
+static inline void test_avl_node_buffer_init_random(void) {
+    for (int i = 0; i < MAX_NODES; i++) {
+        bool key_exists = false;
+        do {
+            key_exists = false;
+            // NOLINTNEXTLINE -- limited randomness is acceptable, concurrency excluded
+            avl_node_buffer[i].key = (avl_key_t)(rand() % MAX_KEY) + 1;
+            for (int j = 0; j < i; j++) {
+                if (avl_node_buffer[j].key == avl_node_buffer[i].key) {
+                    key_exists = true;
+                    break;
+                }
+            }
+        } while (key_exists);
+        avl_node_set_left(&avl_node_buffer[i], NULL);
+        avl_node_set_right(&avl_node_buffer[i], NULL);
+        avl_node_set_parent(&avl_node_buffer[i], NULL);
+#ifndef AVL_TREE_NODE_BALANCE_FACTOR
+        avl_node_buffer[i].height = 0;
+#endif
+        avl_node_inserted[i] = false;
+    }
+}
+
+static inline uint32_t test_count_keys_below(avl_key_t key, bool inclusive) {
+    uint32_t count = 0;
+    for (int i = 0; i < MAX_NODES; i++) {
+        if (avl_node_inserted[i] &&
+            ((avl_node_buffer[i].key < key) || (inclusive && (avl_node_buffer[i].key == key)))) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static inline void test_priority_queue(void) {
+    printf("\n------------------------\n");
+    avl_tree_t queue = {.root = NULL};
+    assert((NULL == avl_tree_pop_min(&queue)) && (NULL == avl_tree_pop_max(&queue)));
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_node_t *inserted = avl_tree_insert(&queue, &avl_node_buffer[i]);
+        assert(inserted == &avl_node_buffer[i]);
+        (void)inserted;
+        assert(AVL_CMP_GT != avl_node_cmp(avl_tree_peek_min(&queue), &avl_node_buffer[i]));
+        assert(AVL_CMP_LT != avl_node_cmp(avl_tree_peek_max(&queue), &avl_node_buffer[i]));
+    }
+    avl_tree_handle_check(&queue);
+    avl_node_spare->key = avl_node_buffer[0].key;
+    avl_node_t *node = avl_tree_insert(&queue, avl_node_spare);
+    assert((node == &avl_node_buffer[0]) && (avl_tree_count(&queue) == MAX_NODES));
+#ifdef AVL_TREE_NODE_CMP_FN_EXTERNAL
+    // Removal by key looks the key up through the external node comparison, as insert does.
+    uint32_t cmp_calls = node_cmp_calls;
+#endif
+    node = avl_tree_remove_key(&queue, avl_node_buffer[1].key);
+    assert(node == &avl_node_buffer[1]);
+#ifdef AVL_TREE_NODE_CMP_FN_EXTERNAL
+    assert(node_cmp_calls > cmp_calls);
+    (void)cmp_calls;
+#endif
+    node = avl_tree_remove_key(&queue, avl_node_buffer[1].key);
+    assert(NULL == node);
+    node = avl_tree_insert(&queue, &avl_node_buffer[1]);
+    assert(node == &avl_node_buffer[1]);
+
+    // Drain from both ends, the last node popped from each end is the new extreme.
+    avl_node_t *last_min = NULL;
+    avl_node_t *last_max = NULL;
+    for (int i = 0; i < MAX_NODES; i++) {
+        node = (0 == (i % 3)) ? avl_tree_pop_max(&queue) : avl_tree_pop_min(&queue);
+        assert(NULL != node);
+        if (0 == (i % 3)) {
+            assert((NULL == last_max) || (AVL_CMP_LT == avl_node_cmp(node, last_max)));
+            last_max = node;
+        } else {
+            assert((NULL == last_min) || (AVL_CMP_GT == avl_node_cmp(node, last_min)));
+            last_min = node;
+        }
+        if (0 == (i % 64)) {
+            avl_tree_handle_check(&queue);
+        }
+    }
+    assert(NULL == queue.root);
+    avl_tree_handle_check(&queue);
+    (void)last_min;
+    (void)last_max;
+    printf("Priority queue passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_insert_remove(void) {
+    printf("\n------------------------\n");
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_tree.root = avl_tree_node_insert(avl_tree.root, &avl_node_buffer[i]);
+        avl_node_inserted[i] = true;
+    }
+    (void)avl_tree_check(avl_tree.root, NULL);
+    for (int i = 0; i < MAX_NODES; i++) {
+        assert(avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key) == &avl_node_buffer[i]);
+    }
+    for (int i = 0; i < MAX_NODES; i += 4) {
+        avl_tree.root = avl_tree_remove_node(avl_tree.root, avl_node_buffer[i].key);
+        avl_node_inserted[i] = false;
+        avl_tree.root = avl_tree_remove_node_ptr(avl_tree.root, &avl_node_buffer[i + 2]);
+        avl_node_inserted[i + 2] = false;
+    }
+    (void)avl_tree_check(avl_tree.root, NULL);
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_node_t *node = avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key);
+        assert(node == (avl_node_inserted[i] ? &avl_node_buffer[i] : NULL));
+        (void)node;
+    }
+    printf("Insert / remove passed\n");
+    printf("------------------------\n");
+}
+
+static int test_key_cmp(const void *a, const void *b) {
+    avl_key_t key_a = *(const avl_key_t *)a;
+    avl_key_t key_b = *(const avl_key_t *)b;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+static inline void test_lookup_batch(void) {
+    printf("\n------------------------\n");
+    // Not a multiple of the group size, present and removed keys mixed.
+    const size_t count = MAX_NODES - 3;
+    avl_key_t keys[MAX_NODES];
+    avl_node_t *nodes[MAX_NODES];
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = avl_node_buffer[(i * 7) % MAX_NODES].key;
+    }
+    avl_tree_node_lookup_batch(avl_tree.root, keys, count, nodes);
+    for (size_t i = 0; i < count; i++) {
+        assert(nodes[i] == avl_tree_node_lookup(avl_tree.root, keys[i]));
+    }
+    avl_tree_node_lookup_batch(NULL, keys, 5, nodes);
+    for (size_t i = 0; i < 5; i++) {
+        assert(NULL == nodes[i]);
+    }
+
+    // Sorted batch with duplicates and keys beyond both ends.
+    keys[0] = 0;
+    keys[1] = (avl_key_t)MAX_KEY + 1;
+    keys[2] = keys[3];
+    qsort(keys, count, sizeof(avl_key_t), test_key_cmp);
+    avl_tree_node_lookup_sorted(avl_tree.root, keys, count, nodes);
+    for (size_t i = 0; i < count; i++) {
+        assert(nodes[i] == avl_tree_node_lookup(avl_tree.root, keys[i]));
+    }
+    avl_tree_node_lookup_sorted(NULL, keys, 5, nodes);
+    for (size_t i = 0; i < 5; i++) {
+        assert(NULL == nodes[i]);
+    }
+    printf("Batch lookup passed\n");
+    printf("------------------------\n");
+}
+
+// Heterogeneous search key: the key as decimal text.
+static avl_node_cmp_result_t test_text_key_cmp(const void *search_key, const avl_node_t *node) {
+    avl_key_t key = (avl_key_t)strtoull((const char *)search_key, NULL, 10);
+    return avl_node_key_cmp(&key, node);
+}
+
+static inline void test_find(void) {
+    printf("\n------------------------\n");
+    for (int i = 0; i < MAX_NODES; i++) {
+        char text[24];
+        (void)snprintf(text, sizeof(text), "%llu", (unsigned long long)avl_node_buffer[i].key);
+        avl_node_t *node = avl_tree_node_find(avl_tree.root, text, test_text_key_cmp);
+        assert(node == (avl_node_inserted[i] ? &avl_node_buffer[i] : NULL));
+        (void)node;
+    }
+    assert(NULL == avl_tree_node_find(avl_tree.root, "0", test_text_key_cmp));
+    assert(NULL == avl_tree_node_find(NULL, "1", test_text_key_cmp));
+    printf("Heterogeneous find passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_eytzinger(void) {
+    printf("\n------------------------\n");
+    avl_key_t keys[MAX_NODES + 1];
+    avl_node_t *nodes[MAX_NODES + 1];
+    avl_tree_eytzinger_t snapshot = {.keys = keys, .nodes = nodes, .count = 0};
+    avl_size_t count = avl_tree_eytzinger_export(&snapshot, avl_tree.root, MAX_NODES);
+    assert(count == test_count_keys_below((avl_key_t)MAX_KEY + 1, false));
+    assert((snapshot.count == count) && (count > 0U));
+    for (avl_size_t i = 2; i <= count; i++) {
+        // Even indices are left children, odd ones right children.
+        avl_node_cmp_result_t expected = (0U != (i & 1U)) ? AVL_CMP_GT : AVL_CMP_LT;
+        assert(avl_node_cmp(nodes[i], nodes[i / 2U]) == expected);
+        (void)expected;
+    }
+    for (avl_key_t key = 0; key <= (avl_key_t)MAX_KEY + 1; key++) {
+        avl_node_t *node = avl_tree_node_lookup(avl_tree.root, key);
+        avl_size_t index = avl_tree_eytzinger_search(&snapshot, key);
+        assert((NULL == node) ? (0U == index) : (nodes[index] == node));
+        (void)node;
+        (void)index;
+    }
+
+    // Too small: nothing is written.
+    avl_size_t needed = avl_tree_eytzinger_export(&snapshot, avl_tree.root, count - 1U);
+    assert((needed == count) && (snapshot.count == count));
+    snapshot.nodes = NULL;
+    needed = avl_tree_eytzinger_export(&snapshot, NULL, MAX_NODES);
+    assert(0U == needed);
+    (void)needed;
+    assert(avl_tree_eytzinger_search(&snapshot, keys[1]) == 0U);
+    printf("Eytzinger snapshot passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_fat_leaf(void) {
+    printf("\n------------------------\n");
+    avl_key_t keys[2 * MAX_NODES];
+    avl_node_t *nodes[MAX_NODES];
+    avl_tree_fat_leaf_t snapshot = {.keys = keys, .nodes = nodes, .count = 0, .levels = 0};
+    avl_size_t count = test_count_keys_below((avl_key_t)MAX_KEY + 1, false);
+    assert(avl_tree_fat_leaf_capacity(count) <= 2 * MAX_NODES);
+    avl_size_t exported = avl_tree_fat_leaf_export(&snapshot, avl_tree.root, 2 * MAX_NODES);
+    assert((exported == count) && (snapshot.count == count) && (snapshot.levels > 1U));
+    for (avl_key_t key = 0; key <= (avl_key_t)MAX_KEY + 1; key++) {
+        avl_node_t *node = avl_tree_node_lookup(avl_tree.root, key);
+        avl_size_t position = avl_tree_fat_leaf_search(&snapshot, key);
+        assert(avl_tree_fat_leaf_lower_bound(&snapshot, key) == test_count_keys_below(key, false));
+        assert((NULL == node) ? (count == position) : (nodes[position] == node));
+        (void)node;
+        (void)position;
+    }
+    exported = avl_tree_fat_leaf_export(&snapshot, avl_tree.root, count);
+    assert((exported == count) && (snapshot.keys == keys));
+
+    // Keys across the whole range, unsigned order must survive the signed vector compares.
+    for (int j = 0; j < OTHER_NODES; j++) {
+        avl_node_buffer_other[j].key = ((avl_key_t)(j + 1) << (AVL_TREE_KEY_BITS - 7)) - 1U;
+    }
+    avl_node_t *other = avl_tree_build_sorted(avl_node_buffer_other, OTHER_NODES);
+    snapshot.nodes = NULL;
+    exported = avl_tree_fat_leaf_export(&snapshot, other, 2 * MAX_NODES);
+    assert(OTHER_NODES == exported);
+    for (avl_size_t j = 0; j < OTHER_NODES; j++) {
+        avl_key_t key = avl_node_buffer_other[j].key;
+        assert(avl_tree_fat_leaf_search(&snapshot, key) == j);
+        assert(avl_tree_fat_leaf_lower_bound(&snapshot, key - 1U) == j);
+        assert(avl_tree_fat_leaf_search(&snapshot, key + 1U) == OTHER_NODES);
+        (void)key;
+    }
+    exported = avl_tree_fat_leaf_export(&snapshot, NULL, 0);
+    assert(0U == exported);
+    assert(avl_tree_fat_leaf_lower_bound(&snapshot, 0) == 0U);
+    (void)exported;
+    printf("Fat-leaf snapshot passed\n");
+    printf("------------------------\n");
+}
+
+static int test_node_key_cmp(const void *a, const void *b) {
+    avl_key_t key_a = ((const avl_node_t *)a)->key;
+    avl_key_t key_b = ((const avl_node_t *)b)->key;
+    return (key_a > key_b) - (key_a < key_b);
+}
+
+static inline void test_build_sorted(void) {
+    printf("\n------------------------\n");
+    qsort(avl_node_buffer, MAX_NODES, sizeof(avl_node_t), test_node_key_cmp);
+    avl_tree_build(&avl_tree, avl_node_buffer, MAX_NODES);
+    avl_tree_handle_check(&avl_tree);
+    for (int i = 0; i < MAX_NODES; i++) {
+        avl_node_inserted[i] = true;
+    }
+    (void)avl_tree_check(avl_tree.root, NULL);
+    for (int i = 0; i < MAX_NODES; i++) {
+        assert(avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key) == &avl_node_buffer[i]);
+    }
+    printf("Build from sorted array passed\n");
+    printf("------------------------\n");
+}
+
+static inline void test_split_join(void) {
+    printf("\n------------------------\n");
+    for (int i = 0; i < MAX_NODES; i += 37) {
+        avl_node_t *left = NULL;
+        avl_node_t *right = NULL;
+        avl_node_t *pivot = avl_tree_split(avl_tree.root, avl_node_buffer[i].key, &left, &right);
+        assert(pivot == (avl_node_inserted[i] ? &avl_node_buffer[i] : NULL));
+        (void)avl_tree_check(left, NULL);
+        (void)avl_tree_check(right, NULL);
+        if ((NULL == pivot) && (NULL != right)) {
+            // The minimum detached from the right tree serves as pivot.
+            pivot = avl_node_find_min(right);
+            right = avl_tree_remove_node_ptr(right, pivot);
+        }
+        avl_tree.root = (NULL == pivot) ? left : avl_tree_join(left, pivot, right);
+        (void)avl_tree_check(avl_tree.root, NULL);
+    }
+    printf("Split / join passed\n");
+    printf("------------------------\n");
+}
+
+#ifdef AVL_TREE_ORDER_STATISTICS
+static inline void test_order_statistics(void) {
+    printf("\n------------------------\n");
+    avl_size_t count = avl_node_size(avl_tree.root);
+    assert(count == test_count_keys_below((avl_key_t)MAX_KEY + 1, true));
+    for (avl_key_t key = 0; key <= 10 * MAX_NODES + 1; key += 7) {
+        avl_size_t rank = avl_tree_node_rank(avl_tree.root, key);
+        assert(rank == test_count_keys_below(key, false));
+        avl_node_t *node = avl_tree_node_select(avl_tree.root, rank);
+        if (rank < count) {
+            assert(NULL != node);
+            assert(node->key >= key);
+            assert(avl_tree_node_rank(avl_tree.root, node->key) == rank);
+        } else {
+            assert(NULL == node);
+        }
+        avl_key_t hi = key + 1000;
+        assert(avl_tree_node_count_range(avl_tree.root, key, hi) ==
+               test_count_keys_below(hi, true) - test_count_keys_below(key, false));
+        assert(avl_tree_node_count_range(avl_tree.root, hi, key) == 0);
+        (void)node;
+        (void)hi;
+    }
+    printf("Order statistics passed\n");
+    printf("------------------------\n");
+}
+#endif
+
+static inline void test_set_operations(void) {
+    printf("\n------------------------\n");
+    avl_tree_t other = {.root = NULL};
+    avl_tree_t removed = {.root = NULL};
+    avl_tree_t duplicates = {.root = NULL};
+    const avl_size_t shared = OTHER_NODES / 2;
+
+    // The tree holds all nodes; half of the other nodes share a key with one of them.
+    for (int j = 0; j < OTHER_NODES; j++) {
+        avl_node_t *node = &avl_node_buffer_other[j];
+        node->key = (0 == (j % 2)) ? avl_node_buffer[(j * 7) % MAX_NODES].key
+                                   : (avl_key_t)(MAX_KEY + 1 + j);
+        avl_node_set_left(node, NULL);
+        avl_node_set_right(node, NULL);
+        avl_node_set_parent(node, NULL);
+        (void)avl_tree_insert(&other, node);
+    }
+
+    avl_tree_handle_check(&avl_tree);
+    avl_size_t count = avl_tree_intersection(&avl_tree, &other, &removed);
+    assert(count == shared);
+    avl_tree_handle_check(&avl_tree);
+    avl_tree_handle_check(&removed);
+    avl_tree_handle_check(&other);
+    assert(avl_tree_count_in(avl_tree.root, other.root, true) == (int)shared);
+    assert(avl_tree_count_in(removed.root, other.root, false) == MAX_NODES - (int)shared);
+    count = avl_tree_union(&avl_tree, &removed, &duplicates);
+    assert((0U == count) && (NULL == removed.root) && (NULL == duplicates.root));
+    avl_tree_handle_check(&avl_tree);
+
+    count = avl_tree_difference(&avl_tree, &other, &removed);
+    assert(count == shared);
+    avl_tree_handle_check(&avl_tree);
+    avl_tree_handle_check(&removed);
+    assert(avl_tree_count_in(avl_tree.root, other.root, false) == MAX_NODES - (int)shared);
+    assert(avl_tree_count_in(removed.root, other.root, true) == (int)shared);
+    count = avl_tree_union(&avl_tree, &removed, NULL);
+    assert(0U == count);
+    avl_tree_handle_check(&avl_tree);
+    avl_tree_handle_check(&removed);
+
+    count = avl_tree_union(&avl_tree, &other, &duplicates);
+    assert((count == shared) && (NULL == other.root));
+    avl_tree_handle_check(&avl_tree);
+    avl_tree_handle_check(&other);
+    avl_tree_handle_check(&duplicates);
+    assert(avl_tree_count(&avl_tree) == MAX_NODES + OTHER_NODES - shared);
+    assert(avl_tree_count_in(duplicates.root, avl_tree.root, true) == (int)shared);
+    for (int i = 0; i < MAX_NODES; i++) {
+        assert(avl_tree_node_lookup(avl_tree.root, avl_node_buffer[i].key) == &avl_node_buffer[i]);
+    }
+    for (int j = 1; j < OTHER_NODES; j += 2) {
+        avl_node_t *node = &avl_node_buffer_other[j];
+        assert(avl_tree_node_lookup(avl_tree.root, node->key) == node);
+        (void)node;
+    }
+    (void)count;
+    (void)shared;
+    printf("Set operations passed\n");
+    printf("------------------------\n");
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+    printf("Size of avl_node_t: %lu Bytes.\n", sizeof(avl_node_t));
+#if defined(AVL_TREE_NODE_INDEX_LINKS) && !defined(AVL_TREE_ORDER_STATISTICS)
+    assert(sizeof(avl_node_t) <= ((16 == AVL_TREE_NODE_INDEX_BITS) ? 16 : 24));
+    assert(sizeof(avl_node_t) <= ((32 == AVL_TREE_KEY_BITS) ? 12 : 24));
+#endif
+#if defined(AVL_TREE_NODE_BALANCE_FACTOR) && !defined(AVL_TREE_NODE_INDEX_LINKS) && \
+    !defined(AVL_TREE_ORDER_STATISTICS)
+    // The balance factor lives in the parent pointer: key and three pointers.
+    assert(sizeof(avl_node_t) == sizeof(avl_key_t) + (3 * sizeof(void *)));
+#endif
+#if defined(AVL_TREE_NODE_NO_PARENT) && !defined(AVL_TREE_ORDER_STATISTICS)
+    // Key, two links and one key-sized word at most for height or balance and padding.
+    assert(sizeof(avl_node_t) <= (2 * sizeof(avl_key_t)) + (2 * sizeof(avl_link_t)));
+#endif
+
+    uint32_t random_seed = (uint32_t)time(NULL);
+    printf("Using random_seed: %d\n", random_seed);
+    srand(random_seed);
+
+    test_avl_node_buffer_init_random();
+    test_priority_queue();
+    test_insert_remove();
+    test_lookup_batch();
+    test_find();
+    test_eytzinger();
+    test_fat_leaf();
+#ifdef AVL_TREE_ORDER_STATISTICS
+    test_order_statistics();
+#endif
+    test_split_join();
+
+    test_build_sorted();
+#ifdef AVL_TREE_ORDER_STATISTICS
+    test_order_statistics();
+#endif
+
+    test_set_operations();
+
+    return 0;
+}